@@ -0,0 +1,96 @@
+// Workspace summaries over N task IDs from membership bitmaps, against the
+// same summaries computed by scanning status, owner and parent columns.
+// The summary is the count per status, and for every person their task
+// count, done count and top-level count.
+//
+// Usage: taskcli_bench_bitmap [task_count] [person_count] [rounds]
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "id_bitmap.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+template <typename Fn>
+double best_seconds(int rounds, Fn&& fn) {
+    double best = 1e30;
+    for (int r = 0; r < rounds; ++r) {
+        auto start = Clock::now();
+        fn();
+        double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        if (elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+constexpr int status_count = 5;
+constexpr int done = 4;
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int task_count = argc > 1 ? std::atoi(argv[1]) : 10000000;
+    int person_count = argc > 2 ? std::atoi(argv[2]) : 100;
+    int rounds = argc > 3 ? std::atoi(argv[3]) : 5;
+
+    // Columns as TaskManager keeps them, and the equivalent bitmaps.
+    std::vector<std::uint8_t> status(task_count + 1);
+    std::vector<std::int32_t> owner(task_count + 1), parent(task_count + 1);
+    std::array<IdBitmap, status_count> status_sets;
+    std::vector<IdBitmap> owner_sets(person_count + 1);
+    IdBitmap child_set;
+    std::uint64_t state = 88172645463325252ULL;
+    for (int id = 1; id <= task_count; ++id) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        status[id] = static_cast<std::uint8_t>(state % status_count);
+        owner[id] = static_cast<std::int32_t>((state >> 8) % (person_count + 1));
+        parent[id] = id % 10 == 1 ? 0 : id - 1;
+        status_sets[status[id]].insert(id);
+        owner_sets[owner[id]].insert(id);
+        if (parent[id]) child_set.insert(id);
+    }
+
+    std::vector<std::array<std::size_t, 3>> by_person(person_count + 1);
+    std::array<std::size_t, status_count> by_status{};
+    double scan_seconds = best_seconds(rounds, [&] {
+        by_status = {};
+        for (auto& counts : by_person) counts = {};
+        for (int id = 1; id <= task_count; ++id) {
+            ++by_status[status[id]];
+            auto& counts = by_person[owner[id]];
+            ++counts[0];
+            counts[1] += status[id] == done;
+            counts[2] += parent[id] == 0;
+        }
+    });
+    std::size_t scan_checksum = by_status[done] + by_person[1][0] + by_person[1][1] + by_person[1][2];
+
+    double bitmap_seconds = best_seconds(rounds, [&] {
+        for (int s = 0; s < status_count; ++s) by_status[s] = status_sets[s].count();
+        for (int p = 0; p <= person_count; ++p) {
+            by_person[p][0] = owner_sets[p].count();
+            by_person[p][1] = IdBitmap::and_count(owner_sets[p], status_sets[done]);
+            by_person[p][2] = IdBitmap::and_not_count(owner_sets[p], child_set);
+        }
+    });
+    std::size_t bitmap_checksum = by_status[done] + by_person[1][0] + by_person[1][1] + by_person[1][2];
+
+    std::size_t bitmap_bytes = child_set.memory_bytes();
+    for (const IdBitmap& set : status_sets) bitmap_bytes += set.memory_bytes();
+    for (const IdBitmap& set : owner_sets) bitmap_bytes += set.memory_bytes();
+
+    std::cout << "summary of " << task_count << " tasks, " << person_count << " people\n"
+              << "  column scan: " << scan_seconds * 1e3 << " ms (checksum " << scan_checksum << ")\n"
+              << "  bitmaps:     " << bitmap_seconds * 1e3 << " ms (checksum " << bitmap_checksum << ", "
+              << bitmap_bytes / (1 << 20) << " MiB)\n";
+    return scan_checksum == bitmap_checksum ? 0 : 1;
+}
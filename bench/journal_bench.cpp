@@ -0,0 +1,84 @@
+// Mutating-command throughput with the journal under each fsync policy, and
+// replay speed of the resulting journal.
+//
+// Usage: taskcli_bench_journal [command_count] [per_command_fsync_count] [path]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "journal.hpp"
+#include "person.hpp"
+#include "person_manager.hpp"
+#include "task.hpp"
+#include "task_manager.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// The mix a busy session produces: add a task, assign it, advance it.
+void run(FsyncPolicy policy, const char* label, int command_count, const std::string& path) {
+    std::remove(path.c_str());
+    TaskManager tm;
+    PersonManager pm;
+    Journal journal;
+    journal.set_fsync_policy(policy, 10);
+    journal.open(path, tm, pm);
+    pm.add_person("owner");
+    journal.append(JournalOp::PersonAdd, "owner");
+    Person* owner = pm.find_person_by_name("owner");
+
+    auto start = Clock::now();
+    int id = 0;
+    for (int i = 0; i < command_count; ++i) {
+        switch (i % 3) {
+        case 0:
+            id = tm.create_task("Task " + std::to_string(i), "Benchmark task", nullptr);
+            journal.append(JournalOp::TaskAdd, id, "Task " + std::to_string(i), "Benchmark task", "");
+            break;
+        case 1:
+            tm.assign_task(id, owner);
+            journal.append(JournalOp::TaskSetOwner, id, "owner");
+            break;
+        default:
+            tm.advance_task_status(id);
+            journal.append(JournalOp::TaskSetStatus, id, static_cast<int>(tm.get_task(id)->get_status()));
+            break;
+        }
+    }
+    journal.close();  // Includes the final sync
+    double elapsed = seconds_since(start);
+    std::cout << label << ": " << command_count << " commands in " << elapsed * 1e3 << " ms, "
+              << command_count / elapsed << " commands/s\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int command_count = argc > 1 ? std::atoi(argv[1]) : 300000;
+    int per_command_count = argc > 2 ? std::atoi(argv[2]) : 3000;
+    std::string path = argc > 3 ? argv[3] : "bench.journal";
+
+    run(FsyncPolicy::PerCommand, "fsync per command", per_command_count, path);
+    run(FsyncPolicy::Group, "group commit (10 ms)", command_count, path);
+    run(FsyncPolicy::None, "no fsync", command_count, path);
+
+    TaskManager tm;
+    PersonManager pm;
+    Journal journal;
+    auto start = Clock::now();
+    journal.open(path, tm, pm);
+    double elapsed = seconds_since(start);
+    std::cout << "replay: " << journal.get_replayed_count() << " records in " << elapsed * 1e3 << " ms, "
+              << journal.get_replayed_count() / elapsed << " records/s, " << journal.get_size() / 1e6 << " MB\n";
+    journal.close();
+    std::remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,80 @@
+// Streaming JSON export and import throughput, and how much the import
+// grows the process beyond the workspace it builds.
+//
+// Usage: taskcli_bench_json [task_count] [person_count] [path]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <sys/resource.h>
+
+#include "person.hpp"
+#include "person_manager.hpp"
+#include "task.hpp"
+#include "task_manager.hpp"
+#include "workspace_json.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+long max_rss_mb() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int task_count = argc > 1 ? std::atoi(argv[1]) : 2000000;
+    int person_count = argc > 2 ? std::atoi(argv[2]) : 1000;
+    std::string path = argc > 3 ? argv[3] : "bench.json";
+
+    double file_mb = 0;
+    long built_rss = 0;
+    {
+        TaskManager tm;
+        PersonManager pm;
+        for (int i = 0; i < person_count; ++i) {
+            pm.add_person("person-" + std::to_string(i));
+        }
+        for (int i = 1; i <= task_count; ++i) {
+            Person* owner = pm.find_person_by_name("person-" + std::to_string(i % person_count));
+            int id = tm.create_task("Task " + std::to_string(i), "Description of task " + std::to_string(i), owner);
+            if (i % 10 != 1) {
+                tm.make_child_task(id - (i % 10 == 0 ? 9 : 1), id);  // chains of 10
+            }
+        }
+        built_rss = max_rss_mb();
+
+        auto start = Clock::now();
+        std::ofstream out(path, std::ios::binary);
+        export_json(out, tm, pm);
+        file_mb = static_cast<double>(out.tellp()) / 1e6;
+        out.close();
+        double elapsed = seconds_since(start);
+        std::cout << "export: " << file_mb << " MB in " << elapsed * 1e3 << " ms, " << file_mb / elapsed << " MB/s\n";
+        std::cout << "max RSS after building + export: " << max_rss_mb() << " MB (workspace alone: " << built_rss << " MB)\n";
+    }
+
+    TaskManager tm;
+    PersonManager pm;
+    auto start = Clock::now();
+    std::ifstream in(path, std::ios::binary);
+    int ok = import_json(in, tm, pm);
+    double elapsed = seconds_since(start);
+    std::cout << "import: " << (ok ? "ok" : "FAILED") << ", " << file_mb << " MB in " << elapsed * 1e3 << " ms, "
+              << file_mb / elapsed << " MB/s, " << task_count / elapsed / 1e6 << " M tasks/s\n";
+    std::cout << "max RSS after import: " << max_rss_mb() << " MB\n";
+    std::remove(path.c_str());
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,68 @@
+// Time to print the whole workspace the way "task list -v -n" does, in each
+// --format, through std::cout with the default stdio synchronisation of an
+// interactive run.
+// Output goes to stdout and the timings to stderr, so redirect stdout to the
+// destination to measure (/dev/null, a file, a pipe).
+//
+// Usage: taskcli_bench_print [task_count] [rounds] > /dev/null
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <utility>
+
+#include "output_sink.hpp"
+#include "person.hpp"
+#include "person_manager.hpp"
+#include "print_options.hpp"
+#include "task.hpp"
+#include "task_manager.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int task_count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 3;
+
+    TaskManager tm;
+    PersonManager pm;
+    pm.add_person("alice");
+    Person* alice = pm.find_person_by_name("alice");
+    for (int i = 1; i <= task_count; ++i) {
+        int id = tm.create_task("Task " + std::to_string(i), "Description of task " + std::to_string(i),
+                                i % 2 ? alice : nullptr);
+        if (i % 10 != 1) {
+            tm.make_child_task(id - 1, id);  // Chains of 10, so levels 1 to 10
+        }
+    }
+
+    const std::pair<const char*, OutputFormat> formats[] = {
+        {"text", OutputFormat::Text}, {"jsonl", OutputFormat::Jsonl},
+        {"csv", OutputFormat::Csv}, {"tsv", OutputFormat::Tsv}};
+    for (auto [name, format] : formats) {
+        PrintOptions options;
+        options.verbose = true;
+        options.nested = true;
+        options.format = format;
+
+        double best = 1e30;
+        for (int r = 0; r < rounds; ++r) {
+            auto start = Clock::now();
+            tm.print_all_tasks(options);
+            get_output().flush();
+            std::cout.flush();
+            double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            if (seconds < best) best = seconds;
+        }
+        std::cerr << "task list -v -n --format " << name << " over " << task_count << " tasks: " << best * 1e3
+                  << " ms (" << task_count / best / 1e6 << " M tasks/s)\n";
+    }
+
+    tm.unown_all_tasks();
+    return 0;
+}
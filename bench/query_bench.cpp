@@ -0,0 +1,76 @@
+// task query latency over N tasks, for queries answered by a full column
+// scan and by the status, owner and child indexes.
+//
+// Usage: taskcli_bench_query [task_count] [rounds]
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "person.hpp"
+#include "person_manager.hpp"
+#include "task.hpp"
+#include "task_manager.hpp"
+#include "task_query.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int task_count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 5;
+    const int person_count = 1000;
+
+    TaskManager tm;
+    PersonManager pm;
+    for (int i = 0; i < person_count; ++i) {
+        pm.add_person("person-" + std::to_string(i));
+    }
+    for (int i = 1; i <= task_count; ++i) {
+        Person* owner = pm.find_person_by_name("person-" + std::to_string(i % person_count));
+        int id = tm.create_task("Task " + std::to_string(i), "", owner);
+        // Mostly Todo and Done, 1% InProgress, 0.1% Blocked
+        Task::Status status = i % 1000 == 0 ? Task::Status::Blocked
+                            : i % 100 == 0 ? Task::Status::InProgress
+                            : i % 2 ? Task::Status::Todo : Task::Status::Done;
+        tm.get_task(id)->set_status(status);
+        if (i % 10 != 1) tm.make_child_task(id - 1, id);  // Chains of 10
+    }
+
+    const std::vector<std::vector<std::string_view>> queries = {
+        {"status=Blocked"},
+        {"status=InProgress", "level>5"},
+        {"status=Done"},
+        {"owner!=person-1", "level>8", "status!=Done"},
+        {"owner=person-700", "status=InProgress"},
+        {"parent=500001"},
+    };
+    QueryResult result;
+    for (const auto& terms : queries) {
+        TaskQuery query;
+        std::string error;
+        if (!compile_task_query(terms, pm, query, error)) {
+            std::cerr << error << "\n";
+            return 1;
+        }
+        double best = 1e30;
+        for (int r = 0; r < rounds; ++r) {
+            auto start = Clock::now();
+            tm.select(query, result);
+            double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            if (seconds < best) best = seconds;
+        }
+        std::string label;
+        for (std::string_view term : terms) label += std::string(term) + " ";
+        std::cout << label << ": " << result.ids.size() << " matches in " << best * 1e3 << " ms ("
+                  << query_access_name(result.access) << ", " << result.examined << " examined)\n";
+    }
+    tm.unown_all_tasks();
+    return 0;
+}
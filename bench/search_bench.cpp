@@ -0,0 +1,71 @@
+// Full-text search over N tasks: time to build the index (the first search
+// does), its size, and the latency of a few searches, then the cost of
+// keeping it up to date as tasks are created and renamed.
+//
+// Usage: taskcli_bench_search [task_count] [rounds]
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "task_manager.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const char* const verbs[] = {"Fix", "Write", "Review", "Refactor", "Test", "Deploy", "Document", "Profile"};
+const char* const nouns[] = {"login", "parser", "journal", "snapshot", "scheduler", "exporter", "cache",
+                             "tokenizer", "planner", "dashboard", "billing", "search"};
+const char* const details[] = {"hangs on large inputs", "drops the last record", "is slow after restart",
+                               "needs better errors", "leaks file handles", "ignores the config"};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int task_count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 5;
+
+    TaskManager tm;
+    auto create = [&](int i) {
+        unsigned h = static_cast<unsigned>(i) * 2654435761u;
+        std::string name = std::string(verbs[h % 8]) + " " + nouns[(h >> 8) % 12] + " #" + std::to_string(i);
+        std::string description = std::string("The ") + nouns[(h >> 16) % 12] + " " + details[(h >> 24) % 6];
+        return tm.create_task(name, description);
+    };
+    for (int i = 1; i <= task_count; ++i) create(i);
+
+    auto start = Clock::now();
+    const TextIndex& index = tm.get_text_index();
+    double build = std::chrono::duration<double>(Clock::now() - start).count();
+    std::cout << "index of " << task_count << " tasks built in " << build * 1e3 << " ms: "
+              << index.memory_bytes() / (1 << 20) << " MiB in " << index.word_count() << " words and "
+              << index.trigram_count() << " trigrams\n";
+
+    const char* const searches[] = {"parser", "refactor billing", "handles", "token", "leak cache restart",
+                                    "123456", "zebra"};
+    std::vector<SearchHit> hits;
+    for (const char* text : searches) {
+        double best = 1e30;
+        for (int r = 0; r < rounds; ++r) {
+            auto begin = Clock::now();
+            tm.search(text, hits);
+            double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+            if (seconds < best) best = seconds;
+        }
+        std::cout << "search '" << text << "': " << hits.size() << " matches in " << best * 1e3 << " ms\n";
+    }
+
+    const int updates = 100000;
+    start = Clock::now();
+    for (int i = 1; i <= updates; ++i) create(task_count + i);
+    double created = std::chrono::duration<double>(Clock::now() - start).count();
+    start = Clock::now();
+    for (int i = 1; i <= updates; ++i) tm.set_task_name(i * (task_count / updates), "Renamed task");
+    double renamed = std::chrono::duration<double>(Clock::now() - start).count();
+    std::cout << "with the index kept up to date: " << created / updates * 1e6 << " us per create, "
+              << renamed / updates * 1e6 << " us per rename\n";
+    return 0;
+}
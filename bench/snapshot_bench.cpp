@@ -0,0 +1,67 @@
+// Save and load time of a binary snapshot.
+//
+// Usage: taskcli_bench_snapshot [task_count] [person_count] [path]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "person.hpp"
+#include "person_manager.hpp"
+#include "snapshot.hpp"
+#include "task.hpp"
+#include "task_manager.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int task_count = argc > 1 ? std::atoi(argv[1]) : 5000000;
+    int person_count = argc > 2 ? std::atoi(argv[2]) : 1000;
+    std::string path = argc > 3 ? argv[3] : "bench.snapshot";
+
+    std::size_t file_size = 0;
+    {
+        TaskManager tm;
+        PersonManager pm;
+        for (int i = 0; i < person_count; ++i) {
+            pm.add_person("person-" + std::to_string(i));
+        }
+        for (int i = 1; i <= task_count; ++i) {
+            Person* owner = pm.find_person_by_name("person-" + std::to_string(i % person_count));
+            int id = tm.create_task("Task " + std::to_string(i), "Description of task " + std::to_string(i), owner);
+            if (i % 10 != 1) {
+                tm.make_child_task(id - (i % 10 == 0 ? 9 : 1), id);  // chains of 10
+            }
+        }
+
+        auto start = Clock::now();
+        auto image = encode_snapshot(tm, pm);
+        double encode = seconds_since(start);
+        file_size = image.size();
+        start = Clock::now();
+        write_snapshot_file(path, image);
+        double write = seconds_since(start);
+        std::cout << "encode: " << encode * 1e3 << " ms, write+fsync: " << write * 1e3 << " ms, "
+                  << file_size / 1e6 << " MB\n";
+    }
+
+    TaskManager tm;
+    PersonManager pm;
+    auto start = Clock::now();
+    int ok = load_snapshot(path, tm, pm);
+    double load = seconds_since(start);
+    std::cout << "load: " << load * 1e3 << " ms (" << task_count / load / 1e6 << " M tasks/s, "
+              << file_size / load / 1e6 << " MB/s)" << (ok ? "" : " FAILED") << "\n";
+    std::remove(path.c_str());
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,110 @@
+// Scan throughput of the task layout: counts tasks per status and per owner
+// over N tasks, walking Task objects and then TaskManager's columnar store.
+// The "legacy" numbers come from a mirror of the original Task layout (id,
+// level, two std::strings, owner, status, parent and a children vector
+// inline, one heap object per task) so both layouts can be compared from
+// the same binary.
+//
+// Usage: taskcli_bench_task_scan [task_count] [rounds]
+
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "person.hpp"
+#include "task.hpp"
+#include "task_manager.hpp"
+
+namespace {
+
+struct LegacyTask {
+    int id, level;
+    std::string name, description;
+    Person* owner;
+    Task::Status status;
+    LegacyTask* parent;
+    std::vector<LegacyTask*> children;
+};
+
+using Clock = std::chrono::steady_clock;
+
+template <typename Fn>
+double best_seconds(int rounds, Fn&& fn) {
+    double best = 1e30;
+    for (int r = 0; r < rounds; ++r) {
+        auto start = Clock::now();
+        fn();
+        double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        if (elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+void report(const char* label, std::size_t count, double seconds, std::size_t checksum) {
+    std::cout << label << ": " << count / seconds / 1e6 << " M tasks/s ("
+              << seconds * 1e3 << " ms, checksum " << checksum << ")\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int task_count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 5;
+    const Task::Status statuses[] = {Task::Status::Todo, Task::Status::InProgress, Task::Status::Blocked,
+                                     Task::Status::Cancelled, Task::Status::Done};
+    Person alice("alice", 1), bob("bob", 2);
+
+    std::vector<std::unique_ptr<LegacyTask>> legacy;
+    legacy.reserve(task_count);
+    TaskManager tm;
+    for (int i = 1; i <= task_count; ++i) {
+        std::string name = "Task number " + std::to_string(i) + " with a longer name";
+        std::string description = "Description of task " + std::to_string(i) + ", long enough to leave SSO";
+        Person* owner = (i % 3 == 0) ? &alice : (i % 3 == 1 ? &bob : nullptr);
+        Task::Status status = statuses[i % 5];
+
+        legacy.push_back(std::make_unique<LegacyTask>(
+            LegacyTask{i, 1, name, description, owner, status, nullptr, {}}));
+        int id = tm.create_task(name, description, owner);
+        tm.get_task(id)->set_status(status);
+    }
+
+    std::cout << "sizeof(LegacyTask) = " << sizeof(LegacyTask)
+              << ", sizeof(Task) = " << sizeof(Task) << "\n";
+
+    std::size_t checksum = 0;
+    double legacy_seconds = best_seconds(rounds, [&] {
+        std::array<std::size_t, 5> counts{};
+        std::size_t owned = 0;
+        for (const auto& task : legacy) {
+            ++counts[static_cast<int>(task->status)];
+            owned += task->owner != nullptr;
+        }
+        checksum = counts[0] + counts[4] + owned;
+    });
+    report("legacy layout", legacy.size(), legacy_seconds, checksum);
+
+    double current_seconds = best_seconds(rounds, [&] {
+        std::array<std::size_t, 5> counts{};
+        std::size_t owned = 0;
+        for (int id = 1; id <= task_count; ++id) {
+            const Task* task = tm.get_task(id);
+            ++counts[static_cast<int>(task->get_status())];
+            owned += task->get_owner() != nullptr;
+        }
+        checksum = counts[0] + counts[4] + owned;
+    });
+    report("hot/cold layout", legacy.size(), current_seconds, checksum);
+
+    double columnar_seconds = best_seconds(rounds, [&] {
+        auto counts = tm.count_tasks_by_status();
+        std::size_t owned = tm.count_tasks_owned_by(alice.get_id()) + tm.count_tasks_owned_by(bob.get_id());
+        checksum = counts[0] + counts[4] + owned;
+    });
+    report("columnar store", legacy.size(), columnar_seconds, checksum);
+    return 0;
+}
@@ -0,0 +1,89 @@
+// Command line splitting throughput: the std::istringstream / std::quoted
+// loop the REPL used to run per line against CommandTokenizer, over a mix of
+// typical commands.
+//
+// Usage: taskcli_bench_tokenizer [line_count] [rounds]
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "command_tokenizer.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+template <typename Fn>
+double best_seconds(int rounds, Fn&& fn) {
+    double best = 1e30;
+    for (int r = 0; r < rounds; ++r) {
+        auto start = Clock::now();
+        fn();
+        double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        if (elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+void report(const char* label, std::size_t tokens, double seconds) {
+    std::cout << label << ": " << tokens / seconds / 1e6 << " M tokens/s (" << seconds * 1e3 << " ms)\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int line_count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 5;
+
+    std::vector<std::string> lines;
+    lines.reserve(line_count);
+    for (int i = 0; i < line_count; ++i) {
+        switch (i % 4) {
+        case 0:
+            lines.push_back("task add -n \"Task number " + std::to_string(i) +
+                            "\" -d \"A description with \\\"quotes\\\" in it\" -o alice");
+            break;
+        case 1: lines.push_back("task set-status " + std::to_string(i) + " InProgress"); break;
+        case 2: lines.push_back("task list -v -n"); break;
+        default: lines.push_back("person rename \"Bob Smith\" \"Robert Smith\""); break;
+        }
+    }
+
+    std::size_t quoted_tokens = 0;
+    double quoted_seconds = best_seconds(rounds, [&] {
+        quoted_tokens = 0;
+        for (const std::string& line : lines) {
+            std::istringstream iss(line);
+            std::string command;
+            iss >> command;
+            std::vector<std::string> args;
+            std::string arg;
+            while (iss >> std::quoted(arg)) {
+                args.push_back(arg);
+            }
+            quoted_tokens += 1 + args.size();
+        }
+    });
+    report("istringstream + std::quoted", quoted_tokens, quoted_seconds);
+
+    CommandTokenizer tokenizer;
+    std::size_t tokens = 0;
+    double tokenizer_seconds = best_seconds(rounds, [&] {
+        tokens = 0;
+        for (const std::string& line : lines) {
+            tokens += tokenizer.tokenize(line).size();
+        }
+    });
+    report("CommandTokenizer", tokens, tokenizer_seconds);
+
+    if (tokens != quoted_tokens) {
+        std::cerr << "Token counts differ: " << tokens << " vs " << quoted_tokens << "\n";
+        return 1;
+    }
+    return 0;
+}
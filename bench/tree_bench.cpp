@@ -0,0 +1,173 @@
+// The task hierarchy with interval labels over N tasks: building a forest
+// through make_child_task (which now checks for cycles), then descendant
+// tests and subtree counts from the labels against walking parent links,
+// then random subtree moves, after which every level and child list is
+// checked, status changes with and without subtree rollups, and deletes:
+// single tasks, whose children move up, then every remaining subtree. Runs
+// a bushy random forest and a single chain of N tasks.
+//
+// Usage: taskcli_bench_tree [task_count] [probes] [moves]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "task.hpp"
+#include "task_manager.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+std::uint64_t next_random(std::uint64_t& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+bool walk_is_descendant(const TaskManager& tm, int id, int ancestor_id) {
+    for (const Task* at = tm.get_task(id)->get_parent(); at; at = at->get_parent()) {
+        if (at->get_id() == ancestor_id) return true;
+    }
+    return false;
+}
+
+// Every task's level follows from its parent's, and its children point back.
+bool consistent(const TaskManager& tm) {
+    bool ok = true;
+    tm.for_each_task([&](const Task* task) {
+        const Task* parent = task->get_parent();
+        ok = ok && task->get_level() == (parent ? parent->get_level() + 1 : 1);
+        for (const Task* child : task->get_children_view()) ok = ok && child->get_parent() == task;
+    });
+    return ok;
+}
+
+bool run(const char* shape, int task_count, int probes, int moves, bool chain) {
+    TaskManager tm;
+    std::uint64_t state = 88172645463325252ULL;
+    auto start = Clock::now();
+    for (int i = 1; i <= task_count; ++i) {
+        int id = tm.create_task("Task " + std::to_string(i), "");
+        if (i == 1) continue;
+        // The chain hangs every task under the last; the forest under a
+        // random earlier task, or at the top level one time in 100.
+        int parent = chain ? id - 1 : next_random(state) % 100 == 0 ? 0 : 1 + next_random(state) % (id - 1);
+        if (parent) tm.make_child_task(parent, id);
+    }
+    double build = seconds_since(start);
+    std::cout << shape << ": " << task_count << " tasks linked in " << build * 1e3 << " ms, "
+              << tm.get_tree().relabel_count() << " labels rewritten\n";
+
+    // The walk over a chain is O(N) per probe, so it gets fewer probes.
+    int walk_probes = chain ? std::max(1, probes / 10000) : probes;
+    int hits = 0;
+    start = Clock::now();
+    for (int i = 0; i < probes; ++i) {
+        int a = 1 + next_random(state) % task_count, b = 1 + next_random(state) % task_count;
+        hits += tm.is_descendant(a, b);
+    }
+    double labels = seconds_since(start) / probes;
+    start = Clock::now();
+    for (int i = 0; i < walk_probes; ++i) {
+        int a = 1 + next_random(state) % task_count, b = 1 + next_random(state) % task_count;
+        hits += walk_is_descendant(tm, a, b);
+    }
+    double walk = seconds_since(start) / walk_probes;
+    std::cout << "  is-descendant: " << labels * 1e9 << " ns from labels, " << walk * 1e9
+              << " ns walking parents (" << hits << " hits)\n";
+
+    start = Clock::now();
+    int under = tm.count_descendants(1);
+    std::cout << "  tasks under task 1: " << under << ", counted in " << seconds_since(start) * 1e3 << " ms\n";
+
+    // Moves under a random task, or to the top level one time in 10; the
+    // ones that would close a cycle are refused. A move costs O(subtree),
+    // which in a chain is half the chain on average, so it gets fewer.
+    if (chain) moves = std::max(1, moves / 10000);
+    std::streambuf* errors = std::cerr.rdbuf(nullptr);  // The refusals
+    int moved = 0;
+    std::size_t carried = 0;
+    double elapsed = 0;
+    for (int i = 0; i < moves; ++i) {
+        int id = 1 + next_random(state) % task_count;
+        int parent = next_random(state) % 10 == 0 ? 0 : 1 + next_random(state) % task_count;
+        start = Clock::now();
+        bool done = tm.move_task(id, parent);
+        elapsed += seconds_since(start);
+        if (done) {
+            ++moved;
+            carried += tm.count_descendants(id) + 1;  // Untimed
+        }
+    }
+    std::cerr.rdbuf(errors);
+    std::cout << "  " << moved << " of " << moves << " moves done in " << elapsed * 1e3 << " ms ("
+              << elapsed / moves * 1e6 << " us each, " << carried / std::max(moved, 1) << " tasks carried on average)\n";
+    // Status changes, before and after the subtree rollups exist; after, each
+    // one also walks up the task's ancestors, so the chain gets fewer.
+    auto change_statuses = [&] {
+        auto begin = Clock::now();
+        for (int i = 0; i < walk_probes; ++i) {
+            int id = 1 + next_random(state) % task_count;
+            tm.get_task(id)->set_status(static_cast<Task::Status>(next_random(state) % Task::status_count));
+        }
+        return seconds_since(begin) / walk_probes;
+    };
+    double plain = change_statuses();
+    start = Clock::now();
+    const auto& counts = tm.subtree_status_counts(1);
+    double rollup_build = seconds_since(start);
+    double rolled = change_statuses();
+    std::cout << "  status change: " << plain * 1e9 << " ns, " << rolled * 1e9 << " ns with rollups (built in "
+              << rollup_build * 1e3 << " ms; task 1 has " << counts[static_cast<int>(Task::Status::Done)] << " done below it)\n";
+
+    if (!consistent(tm)) {
+        std::cerr << "  levels or child lists out of step after the moves\n";
+        return false;
+    }
+
+    // A single delete renumbers the levels below the task, so the chain gets
+    // fewer; IDs already deleted are refused.
+    errors = std::cerr.rdbuf(nullptr);
+    int singles = 0;
+    start = Clock::now();
+    for (int i = 0; i < walk_probes; ++i) singles += tm.delete_task(1 + next_random(state) % task_count);
+    double single = seconds_since(start) / walk_probes;
+    std::cerr.rdbuf(errors);
+    if (!consistent(tm)) {
+        std::cerr << "  levels or child lists out of step after the deletes\n";
+        return false;
+    }
+    std::vector<int> tops;
+    tm.for_each_task([&](const Task* task) {
+        if (!task->get_parent()) tops.push_back(task->get_id());
+    });
+    int removed = 0;
+    start = Clock::now();
+    for (int id : tops) removed += tm.delete_subtree(id);
+    double subtrees = seconds_since(start);
+    std::cout << "  delete: " << single * 1e6 << " us per single task (" << singles << " deleted), then "
+              << removed << " tasks in " << tops.size() << " subtrees in " << subtrees * 1e3 << " ms ("
+              << subtrees / std::max(removed, 1) * 1e9 << " ns per task)\n";
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int task_count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    int probes = argc > 2 ? std::atoi(argv[2]) : 1000000;
+    int moves = argc > 3 ? std::atoi(argv[3]) : 1000000;
+    bool ok = run("random forest", task_count, probes, moves, false);
+    ok = run("chain", task_count, probes, moves, true) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,93 @@
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+class TaskManager;
+class PersonManager;
+class Journal;
+
+struct CheckpointStats {
+    int completed = 0;
+    int failed = 0;
+    // Duration: start until the snapshot is durable. Stall: the part of it
+    // that blocked the command loop (taking the image and rotating the journal).
+    double last_duration_ms = 0, max_duration_ms = 0, total_duration_ms = 0;
+    double last_stall_ms = 0, max_stall_ms = 0, total_stall_ms = 0;
+    std::uint64_t last_snapshot_bytes = 0;
+    std::uint64_t last_lsn = 0;
+};
+
+// Keeps the journal short by folding it into a fresh snapshot. A checkpoint
+// encodes the workspace on the calling thread (the consistent copy), rotates
+// the journal so new commands land in a fresh file, and hands the image to a
+// background thread that writes the snapshot and then deletes the rotated
+// records. Only one checkpoint runs at a time.
+class Checkpointer {
+public:
+    Checkpointer(TaskManager& task_manager, PersonManager& person_manager, Journal& journal);
+    ~Checkpointer();
+
+    Checkpointer(const Checkpointer&) = delete;
+    Checkpointer& operator=(const Checkpointer&) = delete;
+
+    void set_snapshot_path(const std::string& path);
+    // Start a checkpoint once the journal exceeds journal_bytes, or once it
+    // holds records and interval_seconds have passed since the last one.
+    // Zero disables a threshold.
+    void set_thresholds(std::uint64_t journal_bytes, int interval_seconds);
+
+    // Called after every command: collects a finished background checkpoint
+    // and starts a new one if a threshold has been crossed.
+    void poll();
+
+    // Starts a background checkpoint. Returns 1 if one was started, 0 if one
+    // is already running.
+    int start();
+
+    // Checkpoints synchronously, after waiting for a running one. Returns 1
+    // on success.
+    int run();
+
+    // Blocks until the running checkpoint, if any, has finished.
+    void wait();
+
+    bool is_running() const { return worker.joinable(); }
+    const CheckpointStats& get_stats() const { return stats; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void write_in_background(std::vector<char> image);
+    void collect();
+    void record(bool ok, double duration_ms, double stall_ms, std::uint64_t bytes, std::uint64_t lsn);
+
+    TaskManager& task_manager;
+    PersonManager& person_manager;
+    Journal& journal;
+    std::string snapshot_path;
+    std::uint64_t threshold_bytes = 64ull << 20;
+    int threshold_seconds = 300;
+    Clock::time_point last_checkpoint = Clock::now();
+
+    // Background checkpoint in flight. The worker fills in worker_ok and
+    // worker_finished, then sets worker_done; the rest is only touched by the
+    // command loop.
+    std::thread worker;
+    std::atomic<bool> worker_done{false};
+    bool worker_ok = false;
+    Clock::time_point worker_started;
+    Clock::time_point worker_finished;
+    double worker_stall_ms = 0;
+    std::uint64_t worker_bytes = 0;
+    std::uint64_t worker_lsn = 0;
+
+    CheckpointStats stats;
+};
+
+#endif // CHECKPOINT_HPP
@@ -0,0 +1,103 @@
+#ifndef COMMAND_TABLE_HPP
+#define COMMAND_TABLE_HPP
+
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+using CommandArgs = std::span<const std::string_view>;
+
+// One command: how it is spelled, what it takes and what runs it. Dispatch
+// checks min_args before calling run with the arguments after the name, and
+// the help text is generated from usage and summary.
+struct CommandSpec {
+    std::string_view name;
+    std::string_view usage;    // Arguments, e.g. "<task_id> <new_name>"
+    std::string_view summary;
+    std::size_t min_args;
+    int (*run)(CommandArgs args);
+};
+
+// A fixed set of commands looked up through a perfect hash that is found
+// while compiling: a lookup is one hash of the name, one slot and one string
+// compare, however many commands there are. A table whose names cannot be
+// placed without collisions does not compile.
+template <std::size_t N>
+class CommandTable {
+public:
+    consteval explicit CommandTable(const std::array<CommandSpec, N>& commands) : commands(commands) {
+        static_assert(N > 0 && N < empty_slot);
+        while (!place_all()) {
+            if (++seed > 1 << 16) throw "no collision-free seed for this command table";
+        }
+    }
+
+    // Returns the command called name, or nullptr.
+    constexpr const CommandSpec* find(std::string_view name) const {
+        std::uint8_t index = slots[slot_of(name, seed)];
+        if (index == empty_slot || commands[index].name != name) return nullptr;
+        return &commands[index];
+    }
+
+    // In declaration order, which is the order help lists them in.
+    constexpr auto begin() const { return commands.begin(); }
+    constexpr auto end() const { return commands.end(); }
+
+    // Width of the widest "name usage" column, for aligning help text.
+    constexpr std::size_t usage_width() const {
+        std::size_t width = 0;
+        for (const CommandSpec& command : commands) {
+            std::size_t w = command.name.size() + (command.usage.empty() ? 0 : 1 + command.usage.size());
+            if (w > width) width = w;
+        }
+        return width;
+    }
+
+private:
+    static constexpr std::uint8_t empty_slot = 0xFF;
+    static constexpr std::size_t slot_count = std::bit_ceil(2 * N);
+
+    // FNV-1a, seeded.
+    static constexpr std::size_t slot_of(std::string_view name, std::uint32_t seed) {
+        std::uint32_t hash = 2166136261u ^ seed;
+        for (char c : name) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 16777619u;
+        }
+        return (hash ^ (hash >> 16)) & (slot_count - 1);
+    }
+
+    constexpr bool place_all() {
+        slots.fill(empty_slot);
+        for (std::size_t i = 0; i < N; ++i) {
+            std::size_t slot = slot_of(commands[i].name, seed);
+            if (slots[slot] != empty_slot) return false;
+            slots[slot] = static_cast<std::uint8_t>(i);
+        }
+        return true;
+    }
+
+    std::array<CommandSpec, N> commands;
+    std::array<std::uint8_t, slot_count> slots{};
+    std::uint32_t seed = 0;
+};
+
+// Parses a whole token as a decimal int. Returns false on anything else,
+// including trailing characters and out-of-range values.
+inline bool parse_int(std::string_view text, int& value) {
+    const char* end = text.data() + text.size();
+    auto result = std::from_chars(text.data(), end, value);
+    return !text.empty() && result.ec == std::errc() && result.ptr == end;
+}
+
+// The same for an unsigned 64-bit value; a sign is rejected.
+inline bool parse_uint64(std::string_view text, std::uint64_t& value) {
+    const char* end = text.data() + text.size();
+    auto result = std::from_chars(text.data(), end, value);
+    return !text.empty() && result.ec == std::errc() && result.ptr == end;
+}
+
+#endif // COMMAND_TABLE_HPP
@@ -0,0 +1,25 @@
+#ifndef COMMAND_TOKENIZER_HPP
+#define COMMAND_TOKENIZER_HPP
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Splits a command line into whitespace-separated tokens. A token starting
+// with a double quote runs to the next unescaped quote and may contain
+// spaces; inside it a backslash escapes the next character (the rules of
+// std::quoted). Tokens are views into the tokenizer's own copy of the line,
+// unescaped in place, so once its buffers have grown to fit the longest
+// line a reused tokenizer no longer allocates.
+class CommandTokenizer {
+public:
+    // Returns the tokens of line, valid until the next call.
+    std::span<const std::string_view> tokenize(std::string_view line);
+
+private:
+    std::string buffer;
+    std::vector<std::string_view> tokens;
+};
+
+#endif // COMMAND_TOKENIZER_HPP
@@ -0,0 +1,86 @@
+#ifndef ID_BITMAP_HPP
+#define ID_BITMAP_HPP
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// A compressed set of IDs in the style of a roaring bitmap. IDs are grouped
+// into chunks of 65536 by their high 16 bits; a chunk stores its low halves
+// as a sorted array while it is sparse and as a 65536-bit bitset once it is
+// dense. Dense task IDs make most chunks bitsets, so set algebra and counts
+// run as word-wide loops over 8 KiB blocks.
+class IdBitmap {
+public:
+    bool insert(std::uint32_t id);  // Returns false if id was already present
+    bool erase(std::uint32_t id);   // Returns false if id was absent
+    bool contains(std::uint32_t id) const;
+    std::size_t count() const { return cardinality; }
+    bool empty() const { return cardinality == 0; }
+    void clear();
+    // Replaces the contents with ids, which must be strictly ascending. Each
+    // chunk is built once in its final form, for bulk loads.
+    void assign_sorted(std::span<const std::int32_t> ids);
+
+    IdBitmap& operator&=(const IdBitmap& other);
+    IdBitmap& operator|=(const IdBitmap& other);
+    IdBitmap& operator-=(const IdBitmap& other);  // AND NOT
+
+    friend IdBitmap operator&(IdBitmap a, const IdBitmap& b) { return a &= b; }
+    friend IdBitmap operator|(IdBitmap a, const IdBitmap& b) { return a |= b; }
+    friend IdBitmap operator-(IdBitmap a, const IdBitmap& b) { return a -= b; }
+    bool operator==(const IdBitmap& other) const;
+
+    // Sizes of a & b and a - b without building either.
+    static std::size_t and_count(const IdBitmap& a, const IdBitmap& b);
+    static std::size_t and_not_count(const IdBitmap& a, const IdBitmap& b);
+
+    // Visits every ID in ascending order.
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (const Chunk& chunk : chunks) {
+            std::uint32_t high = static_cast<std::uint32_t>(chunk.key) << 16;
+            if (!chunk.dense()) {
+                for (std::uint16_t low : chunk.array) fn(high | low);
+                continue;
+            }
+            for (std::uint32_t w = 0; w < bitset_words; ++w) {
+                for (std::uint64_t word = chunk.bits[w]; word; word &= word - 1) {
+                    fn(high | (w << 6) | static_cast<std::uint32_t>(std::countr_zero(word)));
+                }
+            }
+        }
+    }
+
+    std::size_t memory_bytes() const;  // Heap bytes held by the chunks
+
+private:
+    static constexpr std::uint32_t bitset_words = 1024;  // 65536 bits
+    static constexpr std::size_t array_limit = 4096;  // A fuller array chunk becomes a bitset
+    static constexpr std::size_t array_floor = 2048;  // An emptier bitset chunk becomes an array
+
+    struct Chunk {
+        std::uint16_t key;  // High 16 bits of the IDs
+        std::uint32_t count = 0;
+        std::vector<std::uint16_t> array;  // Sorted low halves while sparse
+        std::vector<std::uint64_t> bits;   // bitset_words words once dense
+
+        bool dense() const { return !bits.empty(); }
+    };
+
+    std::vector<Chunk>::iterator find_chunk(std::uint16_t key);
+    std::vector<Chunk>::const_iterator find_chunk(std::uint16_t key) const;
+    static void to_bitset(Chunk& chunk);
+    static void to_array(Chunk& chunk);
+    static void normalize(Chunk& chunk);  // Picks the container that suits the count
+    static bool contains_low(const Chunk& chunk, std::uint16_t low);
+    static std::size_t and_count(const Chunk& a, const Chunk& b);
+    void recount();
+
+    std::vector<Chunk> chunks;  // Ascending key, none empty
+    std::size_t cardinality = 0;
+};
+
+#endif // ID_BITMAP_HPP
@@ -0,0 +1,152 @@
+#ifndef JOURNAL_HPP
+#define JOURNAL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+class TaskManager;
+class PersonManager;
+
+// Append-only write-ahead journal of workspace mutations. File layout,
+// little-endian:
+//
+//   JournalHeader
+//   records, each: u32 payload size, u32 checksum, u64 LSN, payload
+//
+// A payload is the JournalOp byte followed by its fields, u32 integers and
+// u32-length-prefixed strings. LSNs increase strictly across the life of a
+// workspace (they are not reset by a checkpoint), and each snapshot records
+// the last LSN it contains, so startup loads the snapshot and replays only
+// the newer records. A torn or corrupt tail left by a crash is cut off.
+
+constexpr char journal_magic[8] = {'T', 'A', 'S', 'K', 'J', 'R', 'N', 'L'};
+constexpr std::uint32_t journal_version = 1;
+
+struct JournalHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t reserved;
+};
+
+struct JournalRecordHeader {
+    std::uint32_t payload_size;
+    std::uint32_t checksum;  // Covers the LSN and the payload
+    std::uint64_t lsn;
+};
+
+static_assert(sizeof(JournalHeader) == 16);
+static_assert(sizeof(JournalRecordHeader) == 16);
+
+// Record types and their fields. Owners are recorded by person name, which is
+// what identifies a person across snapshots.
+enum class JournalOp : std::uint8_t {
+    TaskAdd = 1,            // id, name, description, owner name ("" = none)
+    TaskDelete,             // id
+    TaskSetStatus,          // id, status
+    TaskSetOwner,           // id, owner name ("" = unown)
+    TaskUnownAll,           //
+    TaskSetName,            // id, name
+    TaskSetDescription,     // id, description
+    TaskMakeChild,          // parent id, child id
+    PersonAdd,              // name
+    PersonRename,           // old name, new name
+    PersonDelete,           // name
+    PersonDeleteAll,        //
+    PersonDeleteTasks,      // name
+    PersonSetAllTasksDone,  // name
+    TaskMove,               // id, new parent id (0 = top level)
+    TaskDeleteSubtree,      // id
+};
+
+// When appended records reach the disk:
+//   PerCommand  fdatasync before append() returns
+//   Group       a background thread fdatasyncs every group_commit_ms, so a
+//               crash loses at most that window of acknowledged commands
+//   None        left to the kernel's writeback
+enum class FsyncPolicy { PerCommand, Group, None };
+
+class Journal {
+public:
+    Journal() = default;
+    ~Journal();
+
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    // Takes effect at the next open().
+    void set_fsync_policy(FsyncPolicy policy, int group_commit_ms = 10);
+
+    // Opens (creating if needed) the journal at path, replays every record
+    // newer than after_lsn into the managers, truncates a torn tail and
+    // positions for appending. Returns 1 on success, 0 (with a message on
+    // stderr) if the file cannot be used.
+    int open(const std::string& path, TaskManager& task_manager, PersonManager& person_manager,
+             std::uint64_t after_lsn = 0);
+    void close();
+    bool is_open() const { return fd >= 0; }
+
+    // Appends one record and returns its LSN, or 0 if the journal is closed or
+    // the write failed. Fields are ints or strings, in the order listed for op.
+    template <typename... Fields>
+    std::uint64_t append(JournalOp op, const Fields&... fields) {
+        if (fd < 0) return 0;
+        record.resize(sizeof(JournalRecordHeader));
+        record.push_back(static_cast<char>(op));
+        (put_field(fields), ...);
+        return commit_record();
+    }
+
+    // Empties the journal once its records are safely in a snapshot. LSNs
+    // keep counting from get_last_lsn(). Returns 1 on success.
+    int truncate();
+
+    // For checkpoints that run alongside new commands: rotate() moves the
+    // records so far to <path>.old and continues in a fresh file, and
+    // drop_rotated() deletes <path>.old once a snapshot covering it is on
+    // disk. open() replays a leftover <path>.old before the journal itself.
+    // rotate() returns 1 if it rotated, 0 if it did not (an earlier .old is
+    // still pending, or an error was reported) and appends continue as before.
+    int rotate();
+    void drop_rotated();
+
+    // Forces everything appended so far to disk. Returns 1 on success.
+    int sync();
+
+    std::uint64_t get_last_lsn() const { return last_lsn; }
+    std::uint64_t get_size() const { return size; }  // Bytes, header included
+    std::uint64_t get_replayed_count() const { return replayed; }  // Records applied by open()
+
+private:
+    std::uint64_t replay_records(const std::vector<char>& contents, const std::string& label,
+                                 TaskManager& task_manager, PersonManager& person_manager);
+    void put_field(int value);
+    void put_field(std::string_view value);
+    std::uint64_t commit_record();
+    void flush_loop();
+
+    int fd = -1;
+    std::string path;
+    FsyncPolicy policy = FsyncPolicy::PerCommand;
+    int group_commit_ms = 10;
+    std::uint64_t last_lsn = 0;
+    std::uint64_t size = 0;
+    std::uint64_t replayed = 0;
+    std::vector<char> record;  // Encoding buffer, reused by every append
+
+    // Group commit: appends mark the journal dirty and the flusher syncs it.
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable synced;  // Signalled when the flusher's sync returns
+    std::thread flusher;
+    bool dirty = false;
+    bool stopping = false;
+    bool syncing = false;  // The flusher is syncing fd outside the lock
+};
+
+#endif // JOURNAL_HPP
@@ -0,0 +1,101 @@
+#ifndef JSON_STREAM_HPP
+#define JSON_STREAM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Streaming JSON writer. Output is buffered and handed to the stream in
+// blocks; commas and quoting are handled here, nesting is the caller's job.
+class JsonWriter {
+public:
+    explicit JsonWriter(std::ostream& out, std::size_t buffer_size = 1 << 16);
+    ~JsonWriter();
+
+    JsonWriter(const JsonWriter&) = delete;
+    JsonWriter& operator=(const JsonWriter&) = delete;
+
+    void begin_object();
+    void end_object();
+    void begin_array();
+    void end_array();
+    void key(std::string_view name);
+    void value(std::string_view text);
+    void value(const char* text) { value(std::string_view(text)); }
+    void value(std::int64_t number);
+    void null();
+
+    void flush();
+    std::uint64_t bytes_written() const { return written + buffer.size(); }
+
+private:
+    void before_value();
+    void put(char c) { buffer.push_back(c); }
+    void put(std::string_view text) { buffer.append(text); }
+    void maybe_flush() { if (buffer.size() >= buffer_size) flush(); }
+
+    std::ostream& out;
+    std::string buffer;
+    std::size_t buffer_size;
+    std::uint64_t written = 0;
+    struct Scope {
+        bool is_array;
+        bool has_items;
+    };
+    std::vector<Scope> scopes;  // One entry per open object/array
+    bool after_key = false;
+};
+
+// SAX callbacks. Strings and keys arrive unescaped; numbers arrive as their
+// source text so the handler picks the type. The views are only valid for
+// the duration of the call. Returning false stops the parse.
+class JsonHandler {
+public:
+    virtual ~JsonHandler() = default;
+    virtual bool on_begin_object() { return true; }
+    virtual bool on_end_object() { return true; }
+    virtual bool on_begin_array() { return true; }
+    virtual bool on_end_array() { return true; }
+    virtual bool on_key(std::string_view) { return true; }
+    virtual bool on_string(std::string_view) { return true; }
+    virtual bool on_number(std::string_view) { return true; }
+    virtual bool on_bool(bool) { return true; }
+    virtual bool on_null() { return true; }
+};
+
+// Streaming JSON parser. Reads the input in fixed-size blocks and keeps only
+// the container stack and the current token, so memory use does not depend
+// on the document size.
+class JsonParser {
+public:
+    explicit JsonParser(std::istream& in, std::size_t buffer_size = 1 << 16);
+
+    // Parses one JSON document. Returns 1 on success, 0 on a syntax error or
+    // when the handler stops; error() then says why (empty if the handler
+    // stopped without a parse error).
+    int parse(JsonHandler& handler);
+
+    const std::string& error() const { return error_message; }
+    std::uint64_t bytes_read() const { return consumed + position; }
+
+private:
+    int next_char();
+    int next_non_space();
+    bool read_string(std::string_view& text);
+    bool read_number(int first, std::string_view& text);
+    bool expect_literal(const char* rest);
+    int fail(const char* message);  // Records the error, returns 0
+
+    std::istream& in;
+    std::vector<char> buffer;
+    std::size_t position = 0;
+    std::size_t length = 0;
+    std::uint64_t consumed = 0;  // Bytes in blocks already discarded
+    std::string scratch;  // Tokens that straddle blocks or contain escapes
+    std::string error_message;
+};
+
+#endif // JSON_STREAM_HPP
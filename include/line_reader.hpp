@@ -0,0 +1,33 @@
+#ifndef LINE_READER_HPP
+#define LINE_READER_HPP
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+// Splits a file descriptor's contents into lines, reading it in large
+// blocks instead of a syscall or stream extraction per line. Lines are
+// returned without their terminator ("\n" or "\r\n") as views into the
+// block buffer, valid until the next call to next().
+class LineReader {
+public:
+    explicit LineReader(int fd, std::size_t block_size = 1 << 20);
+
+    // Returns false once the input is exhausted.
+    bool next(std::string_view& line);
+
+    bool failed() const { return error; }  // A read() failed, not just EOF
+
+private:
+    bool fill();
+
+    int fd;
+    std::size_t block_size;
+    std::vector<char> buffer;
+    std::size_t begin = 0;  // Unconsumed data is buffer[begin, end)
+    std::size_t end = 0;
+    bool eof = false;
+    bool error = false;
+};
+
+#endif // LINE_READER_HPP
@@ -0,0 +1,64 @@
+#ifndef OUTPUT_SINK_HPP
+#define OUTPUT_SINK_HPP
+
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <iosfwd>
+#include <memory>
+#include <string_view>
+
+// Formats command output into one reusable buffer and hands it to the
+// stream in large blocks, instead of going through the stream's formatting
+// (and, on a terminal, a write per line) for every field. Nothing reaches the
+// stream before flush() or a full buffer, so callers flush once per command.
+class OutputSink {
+public:
+    explicit OutputSink(std::ostream& out, std::size_t capacity = 1 << 16);
+    ~OutputSink();
+
+    OutputSink(const OutputSink&) = delete;
+    OutputSink& operator=(const OutputSink&) = delete;
+
+    OutputSink& operator<<(std::string_view text);
+    OutputSink& operator<<(const char* text) { return *this << std::string_view(text); }
+    OutputSink& operator<<(char c) {
+        if (used == capacity) flush();
+        buffer[used++] = c;
+        return *this;
+    }
+
+    template <std::integral T>
+        requires(!std::same_as<T, char> && !std::same_as<T, bool>)
+    OutputSink& operator<<(T value) {
+        if (capacity - used < max_number_size) flush();
+        used = static_cast<std::size_t>(std::to_chars(buffer.get() + used, buffer.get() + capacity, value).ptr -
+                                        buffer.get());
+        return *this;
+    }
+
+    // Same digits as a default-formatted ostream (%g, six significant digits).
+    OutputSink& operator<<(double value);
+
+    // "--" per level below the top one, matching the nested task listing.
+    void indent(int level);
+
+    // Hands everything buffered so far to the stream. Does not flush the
+    // stream itself.
+    void flush();
+
+    std::size_t pending() const { return used; }
+
+private:
+    static constexpr std::size_t max_number_size = 32;
+
+    std::ostream& out;
+    std::size_t capacity;
+    std::unique_ptr<char[]> buffer;
+    std::size_t used = 0;
+};
+
+// The sink in front of std::cout that all command output goes through.
+OutputSink& get_output();
+
+#endif // OUTPUT_SINK_HPP
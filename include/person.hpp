@@ -1,32 +1,54 @@
 #ifndef PERSON_HPP
 #define PERSON_HPP
 
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 #include "task.hpp"
 #include "print_options.hpp"
 
+class IdBitmap;
+
 class Person {
 public:
-    Person(const std::string& name);
+    Person(const std::string& name, int id = 0);
     ~Person();
 
+    // Tasks point back at their owner, so a Person never changes address.
     Person(const Person&) = delete;
     Person& operator=(const Person&) = delete;
-    Person(Person&&) = default;
-    Person& operator=(Person&&) = default;
+    Person(Person&&) = delete;
+    Person& operator=(Person&&) = delete;
+
+    int get_id() const;
 
     const std::string get_name() const;
+    std::string_view get_name_view() const;
     void set_name(const std::string& new_name);
 
+    // Tasks are owned by TaskManager; these only unassign them from this person.
     void remove_all_tasks();
     void remove_task(Task* task);
     void print_all_tasks(const PrintOptions& options = PrintOptions()) const;
     void set_all_tasks_to_done();
     int return_number_of_tasks(const PrintOptions& options = PrintOptions()) const;
+    // Same count from TaskManager's membership bitmaps (this person's tasks and
+    // the tasks that have a parent), without visiting the tasks.
+    int return_number_of_tasks(const IdBitmap& owned, const IdBitmap& children, const PrintOptions& options) const;
     void assign_task(Task* task);
     std::vector<Task*> get_tasks() const;
+    std::span<Task* const> get_tasks_view() const;
 private:
+    friend class Task;
+
+    // Owner side of the task<->owner link. Each task remembers its index in
+    // `tasks`, so unlinking is a swap with the last entry and a pop.
+    // Only Task::set_owner calls these, keeping both sides consistent.
+    void link_task(Task* task);
+    void unlink_task(Task* task);
+
+    int id;
     std::string name;
     std::vector<Task*> tasks;
 };
@@ -1,13 +1,20 @@
 #ifndef PERSON_MANAGER_HPP
 #define PERSON_MANAGER_HPP
 
+#include <functional>
 #include <string>
+#include <string_view>
 #include <memory>
+#include <span>
+#include <unordered_map>
 #include <vector>
 #include "person.hpp"
+#include "slab_pool.hpp"
 #include "task.hpp"
 #include "print_options.hpp"
 
+class IdBitmap;
+
 class PersonManager {
 public:
 
@@ -15,26 +22,52 @@ public:
     ~PersonManager();
 
     // CRUD operations
-    int change_name(const std::string& old_name, const std::string& new_name);
+    int change_name(std::string_view old_name, std::string_view new_name);
 
     void delete_all_people();
-    int add_person(const std::string& name);
-    int delete_person(const std::string& name);
+    int add_person(std::string_view name);
+    int delete_person(std::string_view name);
 
-    int delete_persons_all_tasks(const std::string& name);
-    int set_persons_all_tasks_as_done(const std::string& name);
-    int assign_task(const std::string& name, Task* task);
+    int unassign_persons_all_tasks(std::string_view name);
+    int set_persons_all_tasks_as_done(std::string_view name);
+    int assign_task(std::string_view name, Task* task);
 
     // Print operations
     void print_all_people(const PrintOptions& options) const;
-    void print_person(const std::string& name, const PrintOptions& options) const;
-    void print_persons_tasks(const std::string& name, const PrintOptions& options) const;
-    void print_all_peoples_task_counts(bool nested) const;
+    void print_person(std::string_view name, const PrintOptions& options) const;
+    void print_persons_tasks(std::string_view name, const PrintOptions& options) const;
+    // owner_sets and child_set are TaskManager's membership bitmaps, the
+    // former indexed by person ID.
+    void print_all_peoples_task_counts(bool nested, std::span<const IdBitmap> owner_sets,
+                                       const IdBitmap& child_set) const;
+
+    Person* find_person_by_name(std::string_view name);
+    const Person* find_person_by_name(std::string_view name) const;
 
-    Person* find_person_by_name(const std::string& name);
-    const Person* find_person_by_name(const std::string& name) const;
+    // Visits every person in the order they were added.
+    template <typename Fn>
+    void for_each_person(Fn&& fn) const {
+        for (Person* person : people) {
+            if (person) fn(person);
+        }
+    }
 private:
-    std::vector<std::unique_ptr<Person>> people;
+    // Transparent hash so the name index can be probed with a string_view
+    // (e.g. a token straight from the command line) without building a std::string.
+    struct NameHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view name) const noexcept {
+            return std::hash<std::string_view>{}(name);
+        }
+    };
+
+    // Person objects live in person_pool; people is a dense slot table indexed
+    // by person ID (slot 0 unused, deleted people leave an empty slot), and
+    // people_by_name indexes the same objects by name.
+    SlabPool<Person> person_pool;
+    std::vector<Person*> people;
+    std::unordered_map<std::string, Person*, NameHash, std::equal_to<>> people_by_name;
+    int next_id = 1;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -1,9 +1,19 @@
 #ifndef PRINT_OPTIONS_HPP
 #define PRINT_OPTIONS_HPP
 
+// Text is the human-oriented layout; the others emit one record per task or
+// person for other tools (see record_writer.hpp).
+enum class OutputFormat {
+    Text,
+    Jsonl,
+    Csv,
+    Tsv
+};
+
 struct PrintOptions {
     bool verbose = false;
     bool nested = false;
+    OutputFormat format = OutputFormat::Text;
 };
 
-#endif // PRINT_OPTIONS_HPP
\ No newline at end of file
+#endif // PRINT_OPTIONS_HPP
@@ -0,0 +1,54 @@
+#ifndef RECORD_WRITER_HPP
+#define RECORD_WRITER_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+#include "print_options.hpp"
+
+class OutputSink;
+class Person;
+class Task;
+
+// Returns false if name is not one of "text", "jsonl", "csv" or "tsv".
+bool parse_output_format(std::string_view name, OutputFormat& format);
+
+// Streams records with a fixed set of columns to an OutputSink, escaping
+// each field as it is copied into the sink's buffer:
+//   Jsonl  one JSON object per line, keyed by column name
+//   Csv    RFC 4180: a header line, fields quoted only when they need it
+//   Tsv    a header line, with tab, newline, carriage return and backslash
+//          written as \t, \n, \r and \\ so every record stays on one line
+// Fields must be written in column order, then end_record().
+class RecordWriter {
+public:
+    RecordWriter(OutputSink& out, OutputFormat format, std::span<const std::string_view> columns);
+
+    void field(std::string_view text);
+    void field(std::int64_t number);
+    void null_field();  // JSON null, an empty field otherwise
+    void end_record();
+
+private:
+    void begin_field();
+    void write_escaped(std::string_view text);
+
+    OutputSink& out;
+    OutputFormat format;
+    std::span<const std::string_view> columns;
+    std::size_t column = 0;  // Index of the next field in the current record
+};
+
+// The record layouts of tasks and people, shared by every command that
+// lists them.
+inline constexpr std::array<std::string_view, 7> task_columns = {
+    "id", "name", "description", "status", "owner", "parent", "level"};
+inline constexpr std::array<std::string_view, 3> person_columns = {"id", "name", "tasks"};
+
+void write_task_record(RecordWriter& writer, const Task& task);
+void write_person_record(RecordWriter& writer, const Person& person);
+
+#endif // RECORD_WRITER_HPP
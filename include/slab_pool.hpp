@@ -0,0 +1,120 @@
+#ifndef SLAB_POOL_HPP
+#define SLAB_POOL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Object pool handing out fixed-size slots carved from contiguous chunks of
+// ChunkSize objects. An object keeps its address for its whole lifetime,
+// destroyed slots are recycled through an intrusive free list, and clear()
+// gives the memory back one chunk at a time.
+template <typename T, std::size_t ChunkSize = 1024>
+class SlabPool {
+public:
+    SlabPool() = default;
+    ~SlabPool() { clear(); }
+
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+
+    template <typename... Args>
+    T* create(Args&&... args) {
+        Slot* slot = acquire_slot();
+        T* object;
+        try {
+            object = ::new (static_cast<void*>(slot->storage)) T(std::forward<Args>(args)...);
+        } catch (...) {
+            release_slot(slot);
+            throw;
+        }
+        ++live;
+        return object;
+    }
+
+    void destroy(T* object) {
+        if (!object) return;
+        object->~T();
+        release_slot(reinterpret_cast<Slot*>(object));
+        --live;
+    }
+
+    // Destroys every live object and frees all chunks.
+    void clear() {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            destroy_live_objects();
+        }
+        chunks.clear();
+        free_list = nullptr;
+        bump = ChunkSize;
+        live = 0;
+    }
+
+    std::size_t size() const { return live; }
+    std::size_t chunk_count() const { return chunks.size(); }
+
+private:
+    union Slot {
+        Slot* next_free;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    Slot* acquire_slot() {
+        if (free_list) {
+            Slot* slot = free_list;
+            free_list = slot->next_free;
+            return slot;
+        }
+        if (bump == ChunkSize) {
+            chunks.push_back(std::make_unique_for_overwrite<Slot[]>(ChunkSize));
+            bump = 0;
+        }
+        return &chunks.back()[bump++];
+    }
+
+    void release_slot(Slot* slot) {
+        slot->next_free = free_list;
+        free_list = slot;
+    }
+
+    // Slots on the free list hold no object; everything else below the bump
+    // pointer does. Mark the free ones first, then run the remaining destructors.
+    void destroy_live_objects() {
+        if (live == 0) return;
+        std::vector<std::pair<const Slot*, std::size_t>> bases;
+        bases.reserve(chunks.size());
+        for (std::size_t c = 0; c < chunks.size(); ++c) {
+            bases.emplace_back(chunks[c].get(), c);
+        }
+        std::sort(bases.begin(), bases.end(), std::less<>());
+
+        std::vector<bool> is_free(chunks.size() * ChunkSize);
+        for (Slot* slot = free_list; slot; slot = slot->next_free) {
+            // Last chunk whose base is not above the slot is the one holding it.
+            auto it = std::upper_bound(bases.begin(), bases.end(), slot,
+                [](const Slot* s, const auto& base) { return std::less<>()(s, base.first); });
+            --it;
+            is_free[it->second * ChunkSize + static_cast<std::size_t>(slot - it->first)] = true;
+        }
+        for (std::size_t c = 0; c < chunks.size(); ++c) {
+            std::size_t used = (c + 1 == chunks.size()) ? bump : ChunkSize;
+            for (std::size_t i = 0; i < used; ++i) {
+                if (!is_free[c * ChunkSize + i]) {
+                    std::launder(reinterpret_cast<T*>(chunks[c][i].storage))->~T();
+                }
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<Slot[]>> chunks;
+    Slot* free_list = nullptr;
+    std::size_t bump = ChunkSize;  // Next unused slot in the newest chunk
+    std::size_t live = 0;
+};
+
+#endif // SLAB_POOL_HPP
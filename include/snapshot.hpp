@@ -0,0 +1,81 @@
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class TaskManager;
+class PersonManager;
+
+// Binary snapshot of a whole workspace. File layout, little-endian:
+//
+//   SnapshotHeader
+//   PersonRecord[person_count]
+//   TaskRecord[task_count]    hierarchy pre-order: each task is followed by its
+//                             whole subtree, and siblings keep their order
+//   string heap               names and descriptions, back to back, no terminators
+//
+// Owners and parents are stored as indexes into the record arrays rather than
+// as names or IDs, so loading needs no lookups. The checksum covers every byte
+// after the header.
+
+constexpr char snapshot_magic[8] = {'T', 'A', 'S', 'K', 'S', 'N', 'A', 'P'};
+constexpr std::uint32_t snapshot_version = 1;
+constexpr std::uint32_t snapshot_no_index = 0xFFFFFFFF;
+
+struct SnapshotHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t header_size;
+    std::uint64_t person_count;
+    std::uint64_t task_count;
+    std::uint64_t string_heap_size;
+    std::uint64_t checksum;
+    std::uint32_t next_task_id;
+    std::uint32_t reserved;
+    std::uint64_t journal_lsn;  // Last journal record already folded into the snapshot
+};
+
+struct PersonRecord {
+    std::uint64_t name_offset;
+    std::uint32_t name_length;
+    std::uint32_t reserved;
+};
+
+struct TaskRecord {
+    std::uint32_t id;
+    std::uint32_t parent;  // Index into the task records, or snapshot_no_index
+    std::uint32_t owner;   // Index into the person records, or snapshot_no_index
+    std::uint8_t status;
+    std::uint8_t reserved[3];
+    std::uint64_t name_offset;  // The description follows the name in the heap
+    std::uint32_t name_length;
+    std::uint32_t description_length;
+};
+
+static_assert(sizeof(SnapshotHeader) == 64);
+static_assert(sizeof(PersonRecord) == 16);
+static_assert(sizeof(TaskRecord) == 32);
+
+// Serializes both managers into an in-memory snapshot image.
+std::vector<char> encode_snapshot(const TaskManager& task_manager, const PersonManager& person_manager,
+                                  std::uint64_t journal_lsn = 0);
+
+// Writes an image atomically (temporary file, fsync, rename). Returns 1 on success.
+int write_snapshot_file(const std::string& path, const std::vector<char>& image);
+
+// encode_snapshot + write_snapshot_file. Returns 1 on success.
+int save_snapshot(const std::string& path, const TaskManager& task_manager, const PersonManager& person_manager,
+                  std::uint64_t journal_lsn = 0);
+
+// Memory-maps a snapshot, validates it and replaces the managers' contents with
+// it. Returns 1 on success, 0 (with a message on stderr) on failure. The
+// snapshot's journal LSN is stored in *journal_lsn when given.
+int load_snapshot(const std::string& path, TaskManager& task_manager, PersonManager& person_manager,
+                  std::uint64_t* journal_lsn = nullptr);
+
+std::uint64_t snapshot_checksum(const char* data, std::size_t size);
+
+#endif // SNAPSHOT_HPP
@@ -1,30 +1,77 @@
 #ifndef TASK_HPP
 #define TASK_HPP
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 class Person;
+class TaskObserver;
 
 class Task {
 public:
-    enum class Status {
+    enum class Status : std::uint8_t {
         Todo,
         InProgress,
         Blocked,
         Cancelled,
         Done
     };
+    static constexpr int status_count = 5;
+    static const char* status_name(Status status);
 
-    Task(int id, const std::string& name, const std::string& description, Person* owner = nullptr, Status status = Status::Todo, Task* parent = nullptr)
-        : id(id), name(name), description(description), owner(owner), status(status), parent(parent), level(1) {}
-    ~Task() = default;
+    // Cold data, only read when a task is printed or its children are walked.
+    // Kept out of line so the hot fields below pack into a small record.
+    // The name and description are views: into one block holding both that
+    // the Details owns, or, for a workspace loaded in bulk, into text its
+    // manager keeps alive.
+    struct Details {
+        explicit Details(std::string_view name = {}, std::string_view description = {}) {
+            assign(name, description);
+        }
+        static Details borrowing(std::string_view name, std::string_view description) {
+            Details details(nullptr);
+            details.name = name;
+            details.description = description;
+            return details;
+        }
+        void assign(std::string_view name, std::string_view description);  // Copies both into a new block
+
+        std::unique_ptr<char[]> text;  // Null while borrowing
+        std::string_view name, description;
+        std::vector<Task*> children;
+        std::int32_t parent_slot = -1;  // Index of this task in parent->children
+
+    private:
+        explicit Details(std::nullptr_t) {}
+    };
+
+    // A standalone task allocates and owns its Details.
+    Task(int id, std::string_view name, std::string_view description, Person* owner = nullptr, Status status = Status::Todo, Task* parent = nullptr)
+        : Task(id, new Details(name, description), owner, status, parent) {
+        owns_details = true;
+    }
+    // A task whose Details live in an external store (TaskManager's pool); the
+    // store frees them after the task is destroyed.
+    Task(int id, Details* details, Person* owner = nullptr, Status status = Status::Todo, Task* parent = nullptr)
+        : id(id), level(1), status(status), owner(nullptr), parent(parent), details(details) {
+        set_owner(owner);
+    }
+    ~Task();
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
 
     const std::string get_name() const;
+    std::string_view get_name_view() const;
     void set_name(const std::string& name);
 
     const std::string get_description() const;
+    std::string_view get_description_view() const;
     void set_description(const std::string& description);
 
     int get_id() const;
@@ -44,16 +91,59 @@ public:
 
     void set_parent(Task* parent);
     Task* get_parent() const;
+    // Unordered like Person's task list: removing a child moves the last
+    // one into its place.
     void add_child(Task* child);
+    void remove_child(Task* child);
     const std::vector<Task*> get_children() const;
-    
+    std::span<Task* const> get_children_view() const;
+
+    void set_observer(TaskObserver* observer);
+    Details* get_details() const;
+
 private:
-    int id, level;
-    std::string name, description;
-    Person* owner;
+    friend class Person;
+
+    std::int32_t id, level;
+    std::int32_t owner_slot = -1;  // Index of this task in owner->tasks
     Status status;
+    bool owns_details = false;
+    Person* owner;
     Task* parent;
-    std::vector<Task*> children;
+    TaskObserver* observer = nullptr;
+    Details* details;
 };
 
+// Visits root and the tasks below it in pre-order, children in list order,
+// as visit(task, depth) with depth 0 for root; visit returns whether to go
+// into that task's children. Iterative: it climbs back up through parent
+// links and each task's slot in its parent's child list, so any depth runs
+// in constant native stack and without allocating.
+template <typename Visit>
+void walk_task_tree(const Task* root, Visit&& visit) {
+    const Task* at = root;
+    int depth = 0;
+    while (true) {
+        auto children = at->get_children_view();
+        if (visit(at, depth) && !children.empty()) {
+            at = children.front();
+            ++depth;
+            continue;
+        }
+        // Next sibling of the nearest task on the way back up that has one.
+        while (at != root) {
+            const Task* parent = at->get_parent();
+            auto siblings = parent->get_children_view();
+            std::size_t next = static_cast<std::size_t>(at->get_details()->parent_slot) + 1;
+            if (next < siblings.size()) {
+                at = siblings[next];
+                break;
+            }
+            at = parent;
+            --depth;
+        }
+        if (at == root) return;
+    }
+}
+
 #endif // TASK_HPP
\ No newline at end of file
@@ -1,18 +1,39 @@
 #ifndef TASK_MANAGER_HPP
 #define TASK_MANAGER_HPP
 
+#include <array>
+#include <cstdint>
 #include <memory>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
+#include "id_bitmap.hpp"
+#include "slab_pool.hpp"
 #include "task.hpp"
+#include "task_tree.hpp"
+#include "text_index.hpp"
+#include "task_observer.hpp"
 #include "print_options.hpp"
 
-class TaskManager {
+struct TaskQuery;
+struct QueryResult;
+
+struct SearchHit {
+    int id;
+    int score;
+};
+
+class TaskManager : private TaskObserver {
 public:
 
     TaskManager() = default;
     ~TaskManager() = default;
 
+    // Tasks hold a pointer back to their manager, so it must stay put.
+    TaskManager(const TaskManager&) = delete;
+    TaskManager& operator=(const TaskManager&) = delete;
+
     void delete_all_tasks();
 
     void print_all_tasks(const PrintOptions& options) const;
@@ -20,7 +41,9 @@ public:
     void print_task(int id, const PrintOptions& options) const;
 
     int create_task(const std::string& name, const std::string& description, Person* owner = nullptr);
-    int delete_task(int id);
+    int delete_task(int id);  // Its children take its place
+    int delete_subtree(int id);  // Returns the number of tasks deleted, 0 if id is missing
+    int delete_tasks_owned_by(Person* person);  // Returns the number of tasks deleted
 
     int assign_task(int id, Person* person);
     void unown_task(int id);
@@ -35,15 +58,172 @@ public:
     int advance_task_status(int id);
     int mark_task_as_done(int id);
 
+    // Fails if either task is missing, the child already has a parent, or
+    // the parent is the child or one of its descendants.
     int make_child_task(int parent_id, int child_id);
+    // Re-parents a task with its subtree (new_parent_id 0 for the top level)
+    // and renumbers the subtree's levels. Same failures as make_child_task,
+    // except that the task may already have a parent.
+    int move_task(int id, int new_parent_id);
+
+    // Hierarchy queries over the tree's interval labels: an O(1) descendant
+    // test, and the descendants of a task in pre-order as fn(task, depth),
+    // depth 1 for its children.
+    bool is_descendant(int id, int ancestor_id) const { return tree.is_descendant(id, ancestor_id); }
+    int count_descendants(int id) const { return static_cast<int>(tree.count_descendants(id)); }
+    template <typename Fn>
+    void for_each_descendant(int id, Fn&& fn) const {
+        tree.for_each_descendant(id, [&](int descendant, int depth) {
+            fn(tasks[descendant], depth);
+            return true;
+        });
+    }
+    const TaskTree& get_tree() const { return tree; }
 
     void print_all_task_owners(const PrintOptions& options) const;
 
     Task* get_task(int id) const;
+
+    // Visits every live task in ID order.
+    template <typename Fn>
+    void for_each_task(Fn&& fn) const {
+        for (Task* task : tasks) {
+            if (task) fn(task);
+        }
+    }
+
+    // Bulk loading (snapshots, imports): recreates a task under a known ID.
+    // Returns nullptr if the ID is invalid or already in use.
+    Task* restore_task(int id, std::string_view name, std::string_view description, Task::Status status,
+                       Person* owner = nullptr);
+    // Bulk loading of a whole workspace in hierarchy pre-order (snapshots).
+    // begin_restore takes an empty manager and the storage that names and
+    // descriptions point into, kept until the tasks are deleted; each
+    // restore_in_order names a valid, unused ID and a parent that is the
+    // previous task or one of its ancestors (null for the top level);
+    // end_restore files every task in the indexes in one pass over the IDs.
+    // The caller validates first.
+    void begin_restore(int max_id, std::shared_ptr<const void> text);
+    Task* restore_in_order(int id, std::string_view name, std::string_view description, Task::Status status,
+                           Person* owner, Task* parent);
+    void end_restore();
+    int get_next_id() const;
+    void reserve_ids(int next_id);  // Never lowers the ID counter
+    void reserve_slots(int max_id);  // Sizes the slot table, columns and tree for IDs up to max_id
+
+    // Whole-table aggregations over the columnar store
+    std::array<int, Task::status_count> count_tasks_by_status() const;
+    int count_tasks_owned_by(int person_id) const;
+
+    // IDs of the tasks in a status, and of one person's tasks in a status
+    // (person 0 for unowned tasks), in no particular order. Invalidated by
+    // the next change to any task's status or owner.
+    std::span<const std::int32_t> tasks_with_status(Task::Status status) const;
+    std::span<const std::int32_t> tasks_with_owner_and_status(int person_id, Task::Status status) const;
+
+    // The same memberships as compressed bitmaps, for set algebra and counts:
+    // the tasks in a status, one person's tasks (person 0 for unowned tasks)
+    // and the tasks that have a parent.
+    const IdBitmap& status_set(Task::Status status) const { return indexes.status_sets[static_cast<int>(status)]; }
+    const IdBitmap& owner_set(int person_id) const {
+        static const IdBitmap none;
+        if (person_id < 0 || static_cast<size_t>(person_id) >= indexes.owner_sets.size()) return none;
+        return indexes.owner_sets[person_id];
+    }
+    const IdBitmap& child_set() const { return indexes.child_set; }
+    std::span<const IdBitmap> owner_sets() const { return indexes.owner_sets; }  // Indexed by person ID
+
+    // How many of a task's descendants are in each status, kept up to date
+    // as statuses and parents change. All zero for a leaf or an unknown ID.
+    using StatusCounts = std::array<std::int32_t, Task::status_count>;
+    const StatusCounts& subtree_status_counts(int id) const;
+
+    // Runs a compiled query (see task_query.hpp) over the columns.
+    void select(const TaskQuery& query, QueryResult& result) const;
+
+    // Full-text search over names and descriptions: the tasks containing
+    // every word of text, case-insensitively and possibly inside a longer
+    // word, best match first. Returns the number of words searched for.
+    int search(std::string_view text, std::vector<SearchHit>& hits) const;
+    const TextIndex& get_text_index() const;
 private:
-    std::vector<std::unique_ptr<Task>> tasks;
+    // Task objects live in task_pool and their cold halves in details_pool
+    // (declared first so it outlives the tasks). tasks is a dense slot table
+    // indexed by task ID where deleted tasks leave an empty slot. IDs are
+    // handed out monotonically and never reused, so a lookup is a bounds
+    // check plus one indexed load.
+    SlabPool<Task::Details> details_pool;
+    SlabPool<Task> task_pool;
+    std::vector<Task*> tasks;
+    int next_id = 1;
+
+    // Struct-of-arrays copy of the hot task fields, indexed by task ID like
+    // `tasks` and kept in sync through the TaskObserver callbacks, so
+    // reporting scans are tight loops over flat arrays. Empty slots have
+    // status empty_status.
+    static constexpr std::uint8_t empty_status = 0xFF;
+    struct Columns {
+        std::vector<std::uint8_t> status;
+        std::vector<std::int32_t> owner;   // Person ID, 0 = no owner
+        std::vector<std::int32_t> parent;  // Task ID, 0 = no parent
+        std::vector<std::int32_t> level;
+    } columns;
+
+    // Per task ID, the status counts of its descendants. Built in one pass
+    // the first time they are asked for, so bulk loads do not pay O(depth)
+    // per link. From then on a status change adjusts the task's ancestors,
+    // and a re-parented task moves its subtree's totals from the old
+    // ancestors to the new ones, both O(depth) up columns.parent.
+    mutable std::vector<StatusCounts> rollups;
+    mutable bool rollups_built = false;
+
+    // Secondary indexes from status and from (owner, status) to task IDs,
+    // updated by the same callbacks as the columns. Lists are unordered: each
+    // task remembers its position in both, so moving it is a swap with the
+    // last entry and a pop, as in Person's task list. The bitmaps hold the
+    // status, owner and has-parent memberships.
+    using StatusLists = std::array<std::vector<std::int32_t>, Task::status_count>;
+    struct Indexes {
+        StatusLists by_status;
+        std::vector<StatusLists> by_owner_status;  // Indexed by person ID
+        std::vector<std::int32_t> status_slot;     // Indexed by task ID
+        std::vector<std::int32_t> owner_slot;
+        std::array<IdBitmap, Task::status_count> status_sets;
+        std::vector<IdBitmap> owner_sets;  // Indexed by person ID
+        IdBitmap child_set;
+    } indexes;
+
+    // Pre/post-order interval labels of the parent links, maintained by
+    // place_task, link_child, delete_task and delete_subtree.
+    TaskTree tree;
+    std::vector<std::int32_t> restore_path;  // Tasks whose subtree is still open during a bulk load
+    std::shared_ptr<const void> restored_text;  // What bulk-loaded tasks' text views point into
+
+    // Words and trigrams of every task's name and description. The first
+    // search builds it, so loading a workspace does not pay for indexing;
+    // from then on the methods that create, rename, redescribe and delete
+    // tasks keep it up to date.
+    mutable TextIndex text_index;
+    mutable bool text_indexed = false;
+
+    Task* place_task(int id, std::string_view name, std::string_view description, Person* owner,
+                     Task::Status status = Task::Status::Todo);
+    void print_task_block(const Task* task, const PrintOptions& options) const;  // One task, as text
+    bool can_parent(int parent_id, int child_id) const;  // Complains on std::cerr if not
+    void link_child(Task* parent, Task* child);  // Updates the tree and the subtree's levels
+    void reclaim_task(int id);  // Leaves the tree and the parent links to the caller
+    void resize_columns(size_t size);
+    void clear_columns(int id);
+    void index_insert(int id);  // Files the task under its status and owner columns
+    void index_erase(int id);
+    void add_to_ancestors(int parent_id, const StatusCounts& counts, int sign);
+    void build_rollups() const;
+
+    void on_status_changed(Task& task, Task::Status old_status) override;
+    void on_owner_changed(Task& task, Person* old_owner) override;
+    void on_parent_changed(Task& task, Task* old_parent) override;
+    void on_level_changed(Task& task) override;
 
-    void print_line_indentations(int level) const;
     Task* find_task_by_id(int id) const;
 };
 
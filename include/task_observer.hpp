@@ -0,0 +1,19 @@
+#ifndef TASK_OBSERVER_HPP
+#define TASK_OBSERVER_HPP
+
+#include "task.hpp"
+
+// Notified after one of a task's indexed fields changes. TaskManager
+// registers itself on every task it creates so its side tables stay in sync
+// even when a Task is mutated directly (e.g. from Person::set_all_tasks_to_done).
+class TaskObserver {
+public:
+    virtual ~TaskObserver() = default;
+
+    virtual void on_status_changed(Task& /*task*/, Task::Status /*old_status*/) {}
+    virtual void on_owner_changed(Task& /*task*/, Person* /*old_owner*/) {}
+    virtual void on_parent_changed(Task& /*task*/, Task* /*old_parent*/) {}
+    virtual void on_level_changed(Task& /*task*/) {}
+};
+
+#endif // TASK_OBSERVER_HPP
@@ -0,0 +1,55 @@
+#ifndef TASK_QUERY_HPP
+#define TASK_QUERY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class PersonManager;
+
+enum class TaskField : std::uint8_t { Id, Status, Owner, Parent, Level, Under };
+enum class CompareOp : std::uint8_t { Eq, Ne, Lt, Le, Gt, Ge };
+
+// One "field op value" term. Values are what TaskManager's columns hold:
+// the status number, the owner's person ID and the parent's task ID (0 for
+// none), the level, or the task ID itself. Under holds for the tasks below
+// the task whose ID is value, at any depth, and only takes =.
+struct TaskPredicate {
+    TaskField field;
+    CompareOp op;
+    std::int32_t value;
+};
+
+// A compiled query: every predicate must hold. Equality on the ID, status,
+// owner or parent also pins down a short candidate list, which the planner
+// prefers to scanning every task.
+struct TaskQuery {
+    std::vector<TaskPredicate> predicates;
+    int task_id = 0;    // From id=<n>
+    int status = -1;    // From status=<s>
+    int owner_id = -1;  // From owner=<name>, 0 for owner=none
+    int parent_id = 0;  // From parent=<n>
+    int under_id = 0;   // From under=<n>
+};
+
+// How TaskManager::select found its candidates.
+enum class QueryAccess { Scan, Id, Status, Owner, OwnerStatus, Children, Subtree };
+const char* query_access_name(QueryAccess access);
+
+struct QueryResult {
+    std::vector<int> ids;  // Ascending
+    QueryAccess access = QueryAccess::Scan;
+    std::size_t examined = 0;  // Candidates the predicates were evaluated on
+};
+
+// Compiles terms such as "status=InProgress", "owner=alice", "level<=2" or
+// "parent=17" (operators =, !=, <, <=, >, >=; "none" for no owner or parent),
+// and "under=17" for every task below task 17.
+// Returns 1 on success, 0 with a message in error.
+int compile_task_query(std::span<const std::string_view> terms, const PersonManager& people,
+                       TaskQuery& query, std::string& error);
+
+#endif // TASK_QUERY_HPP
@@ -0,0 +1,103 @@
+#ifndef TASK_TREE_HPP
+#define TASK_TREE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// The task forest as an Euler tour: every task contributes an enter and an
+// exit token to one linked list, and its descendants are exactly the tokens
+// between its own two. Each token carries a 64-bit label that increases
+// along the list, so "is X under Y" is two label comparisons, and a
+// subtree is a contiguous run of the list.
+//
+// Labels are kept ordered with the order-maintenance scheme of Bender et
+// al.: a new token takes a label between its neighbours, and when they are
+// adjacent the smallest aligned label range around them that is sparse
+// enough is spread out evenly. That costs O(log n) amortized per token.
+//
+// IDs index the storage directly, like TaskManager's columns. ID 0 is the
+// hidden root of the forest: top-level tasks are its children.
+class TaskTree {
+public:
+    void resize(std::size_t size);  // Room for IDs below size; 0 frees everything
+
+    bool contains(int id) const {
+        return id > 0 && static_cast<std::size_t>(id) < size() && next[enter(id)] != absent;
+    }
+
+    // Adds id as the last top-level task.
+    void insert(int id);
+    // Removes id alone: its children take its place in its parent.
+    void erase(int id);
+    // Removes id together with its whole subtree, in O(subtree).
+    void erase_subtree(int id);
+
+    // Bulk building in pre-order: appends id's enter or exit token at the
+    // end of the tour, in O(1). Between opening a task and closing it, the
+    // caller opens and closes exactly its subtree.
+    void open(int id) { link_before(enter(id), exit(0)); }
+    void close(int id) { link_before(exit(id), exit(0)); }
+    // Moves id and its subtree to be the last child of parent_id (0 for the
+    // top level). The caller rules out parent_id being inside the subtree.
+    void attach(int id, int parent_id);
+
+    // Whether id is a strict descendant of ancestor_id. O(1).
+    bool is_descendant(int id, int ancestor_id) const {
+        if (!contains(id) || !contains(ancestor_id)) return false;
+        std::uint64_t at = label[enter(id)];
+        return label[enter(ancestor_id)] < at && at < label[exit(ancestor_id)];
+    }
+
+    // Visits the strict descendants of id in pre-order as fn(id, depth),
+    // depth 1 for its children. Returning false from fn stops the walk.
+    template <typename Fn>
+    void for_each_descendant(int id, Fn&& fn) const {
+        if (!contains(id)) return;
+        int depth = 0;
+        for (Token t = next[enter(id)]; t != exit(id); t = next[t]) {
+            if (t & 1) {
+                --depth;
+            } else if (!fn(t >> 1, ++depth)) {
+                return;
+            }
+        }
+    }
+
+    // Visits every task once, each after all of its descendants.
+    template <typename Fn>
+    void for_each_post_order(Fn&& fn) const {
+        if (next.empty()) return;
+        for (Token t = next[enter(0)]; t != exit(0); t = next[t]) {
+            if (t & 1) fn(t >> 1);
+        }
+    }
+
+    // Number of strict descendants of id, counting no further than limit.
+    std::size_t count_descendants(int id, std::size_t limit = SIZE_MAX) const;
+
+    // Clears keep[i] unless task base + i is a strict descendant of
+    // ancestor_id. A range test over the labels, one slot at a time.
+    void filter_descendants(std::uint8_t* keep, std::size_t base, std::size_t count, int ancestor_id) const;
+
+    std::size_t relabel_count() const { return relabels; }  // Tokens relabeled so far
+
+private:
+    using Token = std::int32_t;  // 2 * id enters a task, 2 * id + 1 leaves it
+    static constexpr Token absent = -1;
+    static constexpr std::uint64_t top = std::uint64_t{1} << 63;  // Label of the root's exit
+
+    static Token enter(int id) { return 2 * id; }
+    static Token exit(int id) { return 2 * id + 1; }
+    std::size_t size() const { return next.size() / 2; }
+
+    void link_before(Token t, Token at);  // Splices t in and labels it
+    void make_room(Token t, std::size_t extra);  // Relabels around t to fit extra tokens after it
+
+    std::vector<Token> next, prev;     // Indexed by token, absent when not in the tour
+    std::vector<std::uint64_t> label;  // Indexed by token, 0 when not in the tour
+    std::vector<Token> scratch;        // Tokens of a subtree being moved
+    std::size_t relabels = 0;
+};
+
+#endif // TASK_TREE_HPP
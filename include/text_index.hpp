@@ -0,0 +1,67 @@
+#ifndef TEXT_INDEX_HPP
+#define TEXT_INDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Inverted index over short documents (a task's name and description)
+// keyed by document ID. Text is split into tokens, runs of ASCII letters
+// and digits plus any non-ASCII bytes, lowercased. Every token posts the
+// document under itself and under each of its trigrams, so a term can be
+// looked up as a whole word or as a substring of one.
+class TextIndex {
+public:
+    // The two texts are indexed together as one document.
+    void add(std::int32_t id, std::string_view name, std::string_view description);
+    void remove(std::int32_t id, std::string_view name, std::string_view description);
+    void clear();
+
+    // Sorted IDs of the documents with term (a lowercase token) as a word.
+    std::span<const std::int32_t> word_matches(std::string_view term) const;
+    // Appends the posting lists a document must be in to contain term
+    // inside a word: one per trigram of term, which makes a superset to
+    // verify against the text. A term shorter than a trigram adds no list:
+    // any document may contain it. Returns false if a list is empty: then no
+    // document contains term.
+    bool candidate_lists(std::string_view term, std::vector<std::span<const std::int32_t>>& lists) const;
+
+    // The IDs present in every list, ascending.
+    static void intersect(std::vector<std::span<const std::int32_t>>& lists, std::vector<std::int32_t>& ids);
+
+    // Appends the lowercase tokens of text.
+    static void tokenize(std::string_view text, std::vector<std::string>& tokens);
+
+    std::size_t memory_bytes() const;  // Postings and keys, roughly
+    std::size_t word_count() const { return words.size(); }
+    std::size_t trigram_count() const { return trigrams.size(); }
+
+private:
+    // Transparent hash so words can be probed with a string_view.
+    struct WordHash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view word) const noexcept {
+            return std::hash<std::string_view>{}(word);
+        }
+    };
+    using Postings = std::vector<std::int32_t>;  // Ascending document IDs
+
+    // The words and trigrams of a document, into scratch.
+    void collect(std::string_view name, std::string_view description);
+    template <typename Fn>
+    static void for_each_token(std::string_view text, std::string& lowered, Fn&& fn);
+
+    std::unordered_map<std::string, Postings, WordHash, std::equal_to<>> words;
+    std::unordered_map<std::uint32_t, Postings> trigrams;  // Three bytes packed
+
+    std::string scratch_name, scratch_description;  // Lowercased
+    std::vector<std::string_view> scratch_words;    // Into those two
+    std::vector<std::uint32_t> scratch_trigrams;
+};
+
+#endif // TEXT_INDEX_HPP
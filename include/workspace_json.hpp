@@ -0,0 +1,32 @@
+#ifndef WORKSPACE_JSON_HPP
+#define WORKSPACE_JSON_HPP
+
+#include <iosfwd>
+#include <string>
+
+class TaskManager;
+class PersonManager;
+
+// JSON interchange format for a whole workspace:
+//
+//   {"format":"taskcli","version":1,"next_task_id":6,
+//    "people":[
+//     {"name":"alice"}, ...],
+//    "tasks":[
+//     {"id":1,"name":"Root","description":"","status":"Todo","owner":"alice","parent":null}, ...]}
+//
+// Exports list tasks parents-first (hierarchy pre-order, siblings in order),
+// one element per line. Imports accept any key order inside an element and
+// ignore unknown keys; people must come before the tasks that they own, and
+// a parent listed after its child is linked once the document ends.
+
+// Streams the workspace to out. Returns 1 on success, 0 on a write error.
+int export_json(std::ostream& out, const TaskManager& task_manager, const PersonManager& person_manager);
+
+// Replaces the managers' contents with the document read from in, parsing
+// it as a stream. Returns 1 on success. On failure returns 0 with a message
+// on stderr; the managers then hold whatever was imported before the error,
+// so callers that need the old workspace back must restore it themselves.
+int import_json(std::istream& in, TaskManager& task_manager, PersonManager& person_manager);
+
+#endif // WORKSPACE_JSON_HPP
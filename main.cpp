@@ -1,14 +1,34 @@
 #include <algorithm>
-#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
 #include <span>
 #include <string>
-#include <sstream>
+#include <string_view>
 #include <vector>
 
+#include "checkpoint.hpp"
+#include "command_table.hpp"
+#include "command_tokenizer.hpp"
+#include "journal.hpp"
+#include "line_reader.hpp"
+#include "output_sink.hpp"
 #include "person_manager.hpp"
 #include "print_options.hpp"
+#include "record_writer.hpp"
+#include "snapshot.hpp"
+#include "task_query.hpp"
 #include "task_manager.hpp"
+#include "workspace_json.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Workspace file loaded at startup and written by 'save'; its journal
+// (snapshot_path + ".journal") holds every change made since.
+static std::string snapshot_path = "taskcli.snapshot";
 
 // Singleton accessor for TaskManager
 TaskManager& get_task_manager() {
@@ -22,390 +42,942 @@ PersonManager& get_person_manager() {
     return instance;
 }
 
-void print_help() {
-    std::cout << "taskcli - Task Manager CLI Tool\n\n";
-    std::cout << "Usage:\n";
-    std::cout << "  taskcli <entity> <command> [options]\n\n";
-    std::cout << "Entities:\n";
-    std::cout << "  task       Manage tasks (add, list, delete, etc.)\n";
-    std::cout << "  person     Manage people (add, list, rename, etc.)\n\n";
-    std::cout << "Global Options:\n";
-    std::cout << "  help       Show this help message\n";
-}
-
-void print_task_help() {
-    std::cout << "taskcli task - Manage tasks\n\n";
-    std::cout << "Usage:\n";
-    std::cout << "  taskcli task <command> [options]\n\n";
-    std::cout << "Commands:\n";
-    std::cout << "  add -n <name> [-d <description>] [-o <owner>]    Add a new task\n";
-    std::cout << "  list [-v:verbose] [-n:nested]                    List all tasks\n";
-    std::cout << "  delete <task_id>                                 Delete a task\n";
-    std::cout << "  complete <task_id>                               Mark a task as complete\n";
-    std::cout << "  print <task_id> [-v:verbose] [-n:nested]         Print a task's details\n";
-    std::cout << "  assign <task_id> <person_name>                   Assign a task to a person\n";
-    std::cout << "  unown <task_id>                                  Unassign a task from its owner\n";
-    std::cout << "  unown-all                                        Unassign all tasks from their owners\n";
-    std::cout << "  set-name <task_id> <new_name>                    Change the name of a task\n";
-    std::cout << "  set-description <task_id> <new_description>      Change the description of a task\n";
-    std::cout << "  advance-status <task_id>                         Advance the status of a task\n";
-    std::cout << "  mark-done <task_id>                              Mark a task as done\n";
-    std::cout << "  make-child <parent_id> <child_id>                Make a task a child of another task\n";
-    std::cout << "  print-owners                                     Print all task owners\n";
-}
-
-void print_person_help() {
-    std::cout << "taskcli person - Manage people\n\n";
-    std::cout << "Usage:\n";
-    std::cout << "  taskcli person <command> [options]\n\n";
-    std::cout << "Commands:\n";
-    std::cout << "  add <name>                                   Add a new person\n";
-    std::cout << "  list [-v:verbose]                            List all people\n";
-    std::cout << "  rename <old-name> <new-name>                 Rename a person\n";
-    std::cout << "  delete <name>                                Delete a person\n";
-    std::cout << "  delete-all                                   Delete all people\n";
-    std::cout << "  delete-tasks                                 Delete all tasks assigned to a person\n";
-    std::cout << "  assign-task <name> <task-id>                 Assign a task to a person\n"; // not working
-    std::cout << "  set-all-tasks-done <name>                    Mark all tasks of a person as done\n";
-    std::cout << "  list-one <name> [-v:verbose]                 List the details of one person\n";
-    std::cout << "  list-tasks <name> [-v:verbose] [-n:nested]   List all tasks of a person\n";
-    std::cout << "  list-tasks-count <name>                      List the count of tasks of a person\n"; // not working
-}
-
-
-int handle_task_command(std::span<const std::string> args) {
-    if (args.empty()) {
-        std::cerr << "Error: No command provided for 'task'. Use 'help' for usage.\n";
-        return 1;
+// Singleton accessor for the write-ahead journal. Successful mutating
+// commands append a record before reporting success.
+Journal& get_journal() {
+    static Journal instance;
+    return instance;
+}
+
+// Singleton accessor for the checkpointer that folds the journal into the snapshot
+Checkpointer& get_checkpointer() {
+    static Checkpointer instance(get_task_manager(), get_person_manager(), get_journal());
+    return instance;
+}
+
+// Logs a change a command has made. Returns false, after reporting it, if
+// the journal could not take the record: the change stays in memory but
+// would not survive a restart, so the command must not report success.
+template <typename... Fields>
+static bool journal_change(JournalOp op, const Fields&... fields) {
+    if (get_journal().append(op, fields...)) {
+        return true;
     }
-    std::string command = args[0];
-    if (command == "help") {
-        print_task_help();
-        return 0;
-    } else if (command == "add") {
-        if (args.size() < 3) {
-            std::cerr << "Error: Not enough arguments for 'add'. Use 'help' for usage.\n";
-            return 1;
-        }
-        std::string name = args[2];
-        std::string description, owner_name;
-        Person* owner = nullptr;
-        for (size_t i = 2; i < args.size(); ++i) {
-            if (args[i] == "-d" && i + 1 < args.size()) {
-                description = args[i + 1];
-                ++i;
-            } else if (args[i] == "-o" && i + 1 < args.size()) {
-                owner_name = args[i + 1];
-                owner = get_person_manager().find_person_by_name(owner_name);
-                if (!owner) {
-                    std::cerr << "Error: Owner '" << owner_name << "' not found.\n";
-                    return 1;
-                }
-                ++i;
-            }
+    std::cerr << "Error: The change was made but not journaled; 'save' to keep it.\n";
+    return false;
+}
+
+// Logs a task's current status, for the commands that change it.
+static bool journal_task_status(int task_id) {
+    Task* task = get_task_manager().get_task(task_id);
+    return !task || journal_change(JournalOp::TaskSetStatus, task_id, static_cast<int>(task->get_status()));
+}
+
+// --- Command handlers ---
+// Each gets the arguments after its name; the tables below check the
+// argument count before calling it.
+
+static bool has_flag(CommandArgs args, std::string_view flag) {
+    return std::find(args.begin(), args.end(), flag) != args.end();
+}
+
+// Parses an ID argument, reporting a malformed one.
+static bool parse_id(std::string_view text, int& id) {
+    if (parse_int(text, id) && id > 0) {
+        return true;
+    }
+    std::cerr << "Error: '" << text << "' is not a valid ID.\n";
+    return false;
+}
+
+// Reads the -v, -n and --format <format> options of the listing commands.
+// Returns false, after reporting it, if the format is missing or unknown.
+static bool parse_print_options(CommandArgs args, PrintOptions& options) {
+    options.verbose = has_flag(args, "-v");
+    options.nested = has_flag(args, "-n");
+    auto format = std::find(args.begin(), args.end(), "--format");
+    if (format == args.end()) {
+        return true;
+    }
+    if (format + 1 == args.end() || !parse_output_format(format[1], options.format)) {
+        std::cerr << "Error: --format takes one of text, jsonl, csv or tsv.\n";
+        return false;
+    }
+    return true;
+}
+
+static void print_task_help();
+static void print_person_help();
+
+static int task_help(CommandArgs) {
+    print_task_help();
+    return 0;
+}
+
+static int task_add(CommandArgs args) {
+    std::string_view name, description, owner_name;
+    bool has_name = false;
+    for (size_t i = 0; i + 1 < args.size(); ++i) {
+        if (args[i] == "-n") {
+            name = args[++i];
+            has_name = true;
+        } else if (args[i] == "-d") {
+            description = args[++i];
+        } else if (args[i] == "-o") {
+            owner_name = args[++i];
         }
-        get_task_manager().create_task(name, description, owner);
-        std::cout << "Task '" << name << "' added successfully.\n";
-    } else if (command == "list") {
-        PrintOptions options;
-        options.verbose = std::find(args.begin(), args.end(), "-v") != args.end();
-        options.nested = std::find(args.begin(), args.end(), "-n") != args.end();
-        get_task_manager().print_all_tasks(options);
-    } else if (command == "delete") {
-        if (args.size() < 2) {
-            std::cerr << "Error: Not enough arguments for 'delete'. Use 'help' for usage.\n";
+    }
+    if (!has_name) {
+        std::cerr << "Error: 'task add' needs -n <name>.\n";
+        return 1;
+    }
+    Person* owner = nullptr;
+    if (!owner_name.empty()) {
+        owner = get_person_manager().find_person_by_name(owner_name);
+        if (!owner) {
+            std::cerr << "Error: Owner '" << owner_name << "' not found.\n";
             return 1;
         }
-        int task_id = std::stoi(args[1]);
-        if (get_task_manager().delete_task(task_id)) {
-            std::cout << "Task with ID " << task_id << " deleted successfully.\n";
-        } else {
+    }
+    int task_id = get_task_manager().create_task(std::string(name), std::string(description), owner);
+    if (!journal_change(JournalOp::TaskAdd, task_id, name, description, owner_name)) return 1;
+    get_output() << "Task '" << name << "' added successfully.\n";
+    return 0;
+}
+
+static int task_list(CommandArgs args) {
+    PrintOptions options;
+    if (!parse_print_options(args, options)) return 1;
+    get_task_manager().print_all_tasks(options);
+    return 0;
+}
+
+// Without --recursive the task's children take its place.
+static int task_delete(CommandArgs args) {
+    int task_id;
+    if (!parse_id(args[0], task_id)) return 1;
+    if (has_flag(args, "--recursive")) {
+        int deleted = get_task_manager().delete_subtree(task_id);
+        if (!deleted) {
             std::cerr << "Error: Failed to delete task with ID " << task_id << ".\n";
-        }
-    } else if (command == "complete") {
-        if (args.size() < 2) {
-            std::cerr << "Error: Not enough arguments for 'complete'. Use 'help' for usage.\n";
-            return 1;
-        }
-        int task_id = std::stoi(args[1]);
-        if (get_task_manager().mark_task_as_done(task_id)) {
-            std::cout << "Task with ID " << task_id << " marked as complete successfully.\n";
-        } else {
-            std::cerr << "Error: Failed to mark task with ID " << task_id << " as complete.\n";
-        }
-    } else if (command == "print") {
-        if (args.size() < 2) {
-            std::cerr << "Error: Not enough arguments for 'print'. Use 'help' for usage.\n";
-            return 1;
-        }
-        int task_id = std::stoi(args[1]);
-        PrintOptions options;
-        options.verbose = std::find(args.begin(), args.end(), "-v") != args.end();
-        options.nested = std::find(args.begin(), args.end(), "-n") != args.end();
-        get_task_manager().print_task(task_id, options);
-    } else if (command == "assign") {
-        if (args.size() < 3) {
-            std::cerr << "Error: Not enough arguments for 'assign'. Use 'help' for usage.\n";
-            return 1;
-        }
-        int task_id = std::stoi(args[1]);
-        std::string person_name = args[2];
-        Person* person = get_person_manager().find_person_by_name(person_name);
-        if (!person) {
-            std::cerr << "Error: Person '" << person_name << "' not found.\n";
-            return 1;
-        }
-        Task* task = get_task_manager().get_task(task_id);
-        if (!task) {
-            std::cerr << "Error: Task with ID " << task_id << " not found.\n";
-            return 1;
-        }
-        if (get_task_manager().assign_task(task_id, person)
-            && get_person_manager().assign_task(person->get_name(), task)) {
-            std::cout << "Task with ID " << task_id << " assigned to " << person_name << " successfully.\n";
-        } else {
-            std::cerr << "Error: Failed to assign task with ID " << task_id << " to " << person_name << ".\n";
-        }
-    } else if (command == "unown") {
-        if (args.size() < 2) {
-            std::cerr << "Error: Not enough arguments for 'unown'. Use 'help' for usage.\n";
-            return 1;
-        }
-        int task_id = std::stoi(args[1]);
-        get_task_manager().unown_task(task_id);
-        std::cout << "Task with ID " << task_id << " unassigned successfully.\n";
-    } else if (command == "unown-all") {
-        get_task_manager().unown_all_tasks();
-        std::cout << "All tasks unassigned successfully.\n";
-    } else if (command == "set--nae") {
-        if (args.size() < 3) {
-            std::cerr << "Error: Not enough arguments for 'set-task-name'. Use 'help' for usage.\n";
-            return 1;
-        }
-        int task_id = std::stoi(args[1]);
-        std::string new_name = args[2];
-        if (get_task_manager().set_task_name(task_id, new_name)) {
-            std::cout << "Task with ID " << task_id << " renamed to '" << new_name << "' successfully.\n";
-        } else {
-            std::cerr << "Error: Failed to rename task with ID " << task_id << ".\n";
-        }
-    } else if (command == "set-description") {
-        if (args.size() < 3) {
-            std::cerr << "Error: Not enough arguments for 'set-description'. Use 'help' for usage.\n";
             return 1;
         }
-        int task_id = std::stoi(args[1]);
-        std::string new_description = args[2];
-        if (get_task_manager().set_task_description(task_id, new_description)) {
-            std::cout << "Task with ID " << task_id << " description updated successfully.\n";
-        } else {
-            std::cerr << "Error: Failed to update description for task with ID " << task_id << ".\n";
-        }
-    } else if (command == "advance-status") {
-        if (args.size() < 2) {
-            std::cerr << "Error: Not enough arguments for 'advance-status'. Use 'help' for usage.\n";
-            return 1;
+        if (!journal_change(JournalOp::TaskDeleteSubtree, task_id)) return 1;
+        get_output() << "Task with ID " << task_id << " and " << deleted - 1 << " tasks under it deleted successfully.\n";
+        return 0;
+    }
+    if (!get_task_manager().delete_task(task_id)) {
+        std::cerr << "Error: Failed to delete task with ID " << task_id << ".\n";
+        return 1;
+    }
+    if (!journal_change(JournalOp::TaskDelete, task_id)) return 1;
+    get_output() << "Task with ID " << task_id << " deleted successfully.\n";
+    return 0;
+}
+
+static int task_complete(CommandArgs args) {
+    int task_id;
+    if (!parse_id(args[0], task_id)) return 1;
+    if (!get_task_manager().mark_task_as_done(task_id)) {
+        std::cerr << "Error: Failed to mark task with ID " << task_id << " as complete.\n";
+        return 1;
+    }
+    if (!journal_task_status(task_id)) return 1;
+    get_output() << "Task with ID " << task_id << " marked as complete successfully.\n";
+    return 0;
+}
+
+static int task_print(CommandArgs args) {
+    int task_id;
+    if (!parse_id(args[0], task_id)) return 1;
+    PrintOptions options;
+    if (!parse_print_options(args, options)) return 1;
+    get_task_manager().print_task(task_id, options);
+    return 0;
+}
+
+static int task_assign(CommandArgs args) {
+    int task_id;
+    if (!parse_id(args[0], task_id)) return 1;
+    std::string_view person_name = args[1];
+    Person* person = get_person_manager().find_person_by_name(person_name);
+    if (!person) {
+        std::cerr << "Error: Person '" << person_name << "' not found.\n";
+        return 1;
+    }
+    if (!get_task_manager().get_task(task_id)) {
+        std::cerr << "Error: Task with ID " << task_id << " not found.\n";
+        return 1;
+    }
+    if (!get_task_manager().assign_task(task_id, person)) {
+        std::cerr << "Error: Failed to assign task with ID " << task_id << " to " << person_name << ".\n";
+        return 1;
+    }
+    if (!journal_change(JournalOp::TaskSetOwner, task_id, person_name)) return 1;
+    get_output() << "Task with ID " << task_id << " assigned to " << person_name << " successfully.\n";
+    return 0;
+}
+
+static int task_unown(CommandArgs args) {
+    int task_id;
+    if (!parse_id(args[0], task_id)) return 1;
+    get_task_manager().unown_task(task_id);
+    if (get_task_manager().get_task(task_id) && !journal_change(JournalOp::TaskSetOwner, task_id, "")) {
+        return 1;
+    }
+    get_output() << "Task with ID " << task_id << " unassigned successfully.\n";
+    return 0;
+}
+
+static int task_unown_all(CommandArgs) {
+    get_task_manager().unown_all_tasks();
+    if (!journal_change(JournalOp::TaskUnownAll)) return 1;
+    get_output() << "All tasks unassigned successfully.\n";
+    return 0;
+}
+
+static int task_set_name(CommandArgs args) {
+    int task_id;
+    if (!parse_id(args[0], task_id)) return 1;
+    std::string_view new_name = args[1];
+    if (!get_task_manager().set_task_name(task_id, std::string(new_name))) {
+        std::cerr << "Error: Failed to rename task with ID " << task_id << ".\n";
+        return 1;
+    }
+    if (!journal_change(JournalOp::TaskSetName, task_id, new_name)) return 1;
+    get_output() << "Task with ID " << task_id << " renamed to '" << new_name << "' successfully.\n";
+    return 0;
+}
+
+static int task_set_description(CommandArgs args) {
+    int task_id;
+    if (!parse_id(args[0], task_id)) return 1;
+    std::string_view new_description = args[1];
+    if (!get_task_manager().set_task_description(task_id, std::string(new_description))) {
+        std::cerr << "Error: Failed to update description for task with ID " << task_id << ".\n";
+        return 1;
+    }
+    if (!journal_change(JournalOp::TaskSetDescription, task_id, new_description)) return 1;
+    get_output() << "Task with ID " << task_id << " description updated successfully.\n";
+    return 0;
+}
+
+static int task_advance_status(CommandArgs args) {
+    int task_id;
+    if (!parse_id(args[0], task_id)) return 1;
+    if (!get_task_manager().advance_task_status(task_id)) {
+        std::cerr << "Error: Failed to advance status for task with ID " << task_id << ".\n";
+        return 1;
+    }
+    if (!journal_task_status(task_id)) return 1;
+    get_output() << "Task with ID " << task_id << " status advanced successfully.\n";
+    return 0;
+}
+
+static int task_mark_done(CommandArgs args) {
+    int task_id;
+    if (!parse_id(args[0], task_id)) return 1;
+    if (!get_task_manager().mark_task_as_done(task_id)) {
+        std::cerr << "Error: Failed to mark task with ID " << task_id << " as done.\n";
+        return 1;
+    }
+    if (!journal_task_status(task_id)) return 1;
+    get_output() << "Task with ID " << task_id << " marked as done successfully.\n";
+    return 0;
+}
+
+static int task_make_child(CommandArgs args) {
+    int parent_id, child_id;
+    if (!parse_id(args[0], parent_id) || !parse_id(args[1], child_id)) return 1;
+    if (!get_task_manager().make_child_task(parent_id, child_id)) {
+        std::cerr << "Error: Failed to make task with ID " << child_id << " a child of task with ID " << parent_id << ".\n";
+        return 1;
+    }
+    if (!journal_change(JournalOp::TaskMakeChild, parent_id, child_id)) return 1;
+    get_output() << "Task with ID " << child_id << " made a child of task with ID " << parent_id << " successfully.\n";
+    return 0;
+}
+
+// task move <id> <new-parent>: "none" (or 0) moves the task to the top level.
+static int task_move(CommandArgs args) {
+    int task_id, parent_id = 0;
+    if (!parse_id(args[0], task_id)) return 1;
+    if (args[1] != "none" && args[1] != "0" && !parse_id(args[1], parent_id)) return 1;
+    if (!get_task_manager().move_task(task_id, parent_id)) {
+        std::cerr << "Error: Failed to move task with ID " << task_id << ".\n";
+        return 1;
+    }
+    if (!journal_change(JournalOp::TaskMove, task_id, parent_id)) return 1;
+    if (parent_id) {
+        get_output() << "Task with ID " << task_id << " moved under task with ID " << parent_id << " successfully.\n";
+    } else {
+        get_output() << "Task with ID " << task_id << " moved to the top level successfully.\n";
+    }
+    return 0;
+}
+
+static int task_print_owners(CommandArgs args) {
+    PrintOptions options;
+    options.nested = has_flag(args, "-n");
+    get_task_manager().print_all_task_owners(options);
+    return 0;
+}
+
+// task query <term>... [-v] [--format <format>] [--count]: the terms are
+// everything that is not an option.
+static int task_query(CommandArgs args) {
+    PrintOptions options;
+    if (!parse_print_options(args, options)) return 1;
+    std::vector<std::string_view> terms;
+    bool count_only = false;
+    for (size_t i = 0; i < args.size(); ++i) {
+        if (args[i] == "--format") {
+            ++i;
+        } else if (args[i] == "--count") {
+            count_only = true;
+        } else if (args[i] != "-v" && args[i] != "-n") {
+            terms.push_back(args[i]);
         }
-        int task_id = std::stoi(args[1]);
-        if (get_task_manager().advance_task_status(task_id)) {
-            std::cout << "Task with ID " << task_id << " status advanced successfully.\n";
+    }
+
+    TaskQuery query;
+    std::string error;
+    if (!compile_task_query(terms, get_person_manager(), query, error)) {
+        std::cerr << "Error: " << error << ".\n";
+        return 1;
+    }
+    static QueryResult result;  // Kept so large results do not regrow it every time
+    auto start = std::chrono::steady_clock::now();
+    get_task_manager().select(query, result);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (!count_only) {
+        if (options.format == OutputFormat::Text) {
+            options.nested = false;
+            for (int id : result.ids) {
+                get_task_manager().print_task(id, options);
+            }
         } else {
-            std::cerr << "Error: Failed to advance status for task with ID " << task_id << ".\n";
-        }
-    } else if (command == "mark-done") {
-        if (args.size() < 2) {
-            std::cerr << "Error: Not enough arguments for 'mark-done'. Use 'help' for usage.\n";
-            return 1;
+            RecordWriter writer(get_output(), options.format, task_columns);
+            for (int id : result.ids) {
+                write_task_record(writer, *get_task_manager().get_task(id));
+            }
         }
-        int task_id = std::stoi(args[1]);
-        if (get_task_manager().mark_task_as_done(task_id)) {
-            std::cout << "Task with ID " << task_id << " marked as done successfully.\n";
-        } else {
-            std::cerr << "Error: Failed to mark task with ID " << task_id << " as done.\n";
+    }
+    // The summary stays off stdout when that carries records.
+    auto report = [&](auto& out) {
+        out << result.ids.size() << " tasks matched in " << seconds * 1e3 << " ms ("
+            << query_access_name(result.access) << ", " << result.examined << " examined).\n";
+    };
+    if (options.format == OutputFormat::Text) {
+        report(get_output());
+    } else {
+        report(std::cerr);
+    }
+    return 0;
+}
+
+// task search <word>... [-v] [--limit <n>] [--format <format>]: the words
+// are everything that is not an option.
+static int task_search(CommandArgs args) {
+    PrintOptions options;
+    if (!parse_print_options(args, options)) return 1;
+    std::string text;
+    int limit = 20;
+    for (size_t i = 0; i < args.size(); ++i) {
+        if (args[i] == "--format") {
+            ++i;
+        } else if (args[i] == "--limit") {
+            if (i + 1 == args.size() || !parse_int(args[i + 1], limit) || limit < 0) {
+                std::cerr << "Error: --limit takes a count (0 = no limit).\n";
+                return 1;
+            }
+            ++i;
+        } else if (args[i] != "-v" && args[i] != "-n") {
+            text.append(args[i]).append(" ");
         }
-    } else if (command == "make-child") {
-        if (args.size() < 3) {
-            std::cerr << "Error: Not enough arguments for 'make-child'. Use --help for usage.\n";
-            return 1;
+    }
+
+    static std::vector<SearchHit> hits;  // Kept so large results do not regrow it every time
+    auto start = std::chrono::steady_clock::now();
+    if (!get_task_manager().search(text, hits)) {
+        std::cerr << "Error: Nothing to search for.\n";
+        return 1;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t shown = limit == 0 ? hits.size() : std::min(hits.size(), static_cast<size_t>(limit));
+    if (options.format == OutputFormat::Text) {
+        options.nested = false;
+        for (size_t i = 0; i < shown; ++i) {
+            get_task_manager().print_task(hits[i].id, options);
         }
-        int parent_id = std::stoi(args[1]);
-        int child_id = std::stoi(args[2]);
-        if(get_task_manager().make_child_task(parent_id, child_id)) {
-            std::cout << "Task with ID " << child_id << " made a child of task with ID " << parent_id << " successfully.\n";
-        } else {
-            std::cerr << "Error: Failed to make task with ID " << child_id << " a child of task with ID " << parent_id << ".\n";
+    } else {
+        RecordWriter writer(get_output(), options.format, task_columns);
+        for (size_t i = 0; i < shown; ++i) {
+            write_task_record(writer, *get_task_manager().get_task(hits[i].id));
         }
-    } else if (command == "print-owners") {
-        PrintOptions options;
-        options.nested = std::find(args.begin(), args.end(), "-n") != args.end();
-        get_task_manager().print_all_task_owners(options);
     }
+    // The summary stays off stdout when that carries records.
+    auto report = [&](auto& out) {
+        out << hits.size() << " tasks matched in " << seconds * 1e3 << " ms";
+        if (shown < hits.size()) out << ", best " << shown << " shown";
+        out << ".\n";
+    };
+    if (options.format == OutputFormat::Text) {
+        report(get_output());
+    } else {
+        report(std::cerr);
+    }
+    return 0;
+}
 
+static int task_stats(CommandArgs) {
+    auto counts = get_task_manager().count_tasks_by_status();
+    int total = 0;
+    for (int s = 0; s < Task::status_count; ++s) {
+        get_output() << Task::status_name(static_cast<Task::Status>(s)) << ": " << counts[s] << "\n";
+        total += counts[s];
+    }
+    get_output() << "Total: " << total << "\n";
     return 0;
 }
 
-int handle_person_command(std::span<const std::string> args) {
-    if (args.empty()) {
-        std::cerr << "Error: No command provided for 'person'. Use 'help' for usage.\n";
+static int person_help(CommandArgs) {
+    print_person_help();
+    return 0;
+}
+
+static int person_add(CommandArgs args) {
+    get_output() << "Adding a new person...\n";
+    std::string_view name = args[0];
+    if (name.empty()) {
+        std::cerr << "Error: Name cannot be empty.\n";
+        return 1;
+    }
+    if (!get_person_manager().add_person(name)) {
         return 1;
     }
-    std::string command = args[0];
-    if (command == "help") {
-        print_person_help();
+    if (!journal_change(JournalOp::PersonAdd, name)) return 1;
+    get_output() << "Person '" << name << "' added successfully.\n";
+    return 0;
+}
+
+static int person_list(CommandArgs args) {
+    PrintOptions options;
+    if (!parse_print_options(args, options)) return 1;
+    if (options.format == OutputFormat::Text) {
+        get_output() << "Listing all people...\n";
+    }
+    get_person_manager().print_all_people(options);
+    return 0;
+}
+
+static int person_rename(CommandArgs args) {
+    std::string_view old_name = args[0];
+    std::string_view new_name = args[1];
+    if (new_name.empty()) {
+        std::cerr << "Error: New name cannot be empty.\n";
+        return 1;
+    }
+    if (!get_person_manager().change_name(old_name, new_name)) {
+        std::cerr << "Error: Failed to rename person '" << old_name << "'.\n";
+        return 1;
+    }
+    if (!journal_change(JournalOp::PersonRename, old_name, new_name)) return 1;
+    get_output() << "Person '" << old_name << "' renamed to '" << new_name << "' successfully.\n";
+    return 0;
+}
+
+static int person_delete(CommandArgs args) {
+    std::string_view name = args[0];
+    if (!get_person_manager().delete_person(name)) {
+        std::cerr << "Error: Failed to delete person '" << name << "'.\n";
+        return 1;
+    }
+    if (!journal_change(JournalOp::PersonDelete, name)) return 1;
+    get_output() << "Person '" << name << "' deleted successfully.\n";
+    return 0;
+}
+
+static int person_delete_all(CommandArgs) {
+    get_person_manager().delete_all_people();
+    if (!journal_change(JournalOp::PersonDeleteAll)) return 1;
+    get_output() << "All people deleted successfully.\n";
+    return 0;
+}
+
+static int person_delete_tasks(CommandArgs args) {
+    std::string_view name = args[0];
+    Person* person = get_person_manager().find_person_by_name(name);
+    if (!person) {
+        std::cerr << "Error: Person '" << name << "' not found.\n";
+        return 1;
+    }
+    get_task_manager().delete_tasks_owned_by(person);
+    if (!journal_change(JournalOp::PersonDeleteTasks, name)) return 1;
+    return 0;
+}
+
+static int person_assign_task(CommandArgs args) {
+    std::string_view name = args[0];
+    int task_id;
+    if (!parse_id(args[1], task_id)) return 1;
+    Task* task = get_task_manager().get_task(task_id);
+    if (task == nullptr) {
+        std::cerr << "Error: Task with ID " << task_id << " not found.\n";
+        return 1;
+    }
+    if (!get_person_manager().assign_task(name, task)) {
+        return 1;
+    }
+    if (!journal_change(JournalOp::TaskSetOwner, task_id, name)) return 1;
+    return 0;
+}
+
+static int person_set_all_tasks_done(CommandArgs args) {
+    std::string_view name = args[0];
+    if (!get_person_manager().set_persons_all_tasks_as_done(name)) {
+        return 1;
+    }
+    if (!journal_change(JournalOp::PersonSetAllTasksDone, name)) return 1;
+    return 0;
+}
+
+static int person_list_one(CommandArgs args) {
+    PrintOptions options;
+    if (!parse_print_options(args, options)) return 1;
+    get_person_manager().print_person(args[0], options);
+    return 0;
+}
+
+static int person_list_tasks(CommandArgs args) {
+    PrintOptions options;
+    if (!parse_print_options(args, options)) return 1;
+    get_person_manager().print_persons_tasks(args[0], options);
+    return 0;
+}
+
+static int person_list_tasks_count(CommandArgs args) {
+    const TaskManager& task_manager = get_task_manager();
+    get_person_manager().print_all_peoples_task_counts(has_flag(args, "-n"), task_manager.owner_sets(),
+                                                       task_manager.child_set());
+    return 0;
+}
+
+static int save_command(CommandArgs args) {
+    std::string path = args.empty() ? snapshot_path : std::string(args[0]);
+    int saved = path == snapshot_path
+        ? get_checkpointer().run()
+        : save_snapshot(path, get_task_manager(), get_person_manager(), get_journal().get_last_lsn());
+    if (!saved) {
+        return 1;
+    }
+    get_output() << "Workspace saved to '" << path << "'.\n";
+    return 0;
+}
+
+static int load_command(CommandArgs args) {
+    std::string path = args.empty() ? snapshot_path : std::string(args[0]);
+    get_checkpointer().wait();  // It may be writing the file we are about to read
+    if (!load_snapshot(path, get_task_manager(), get_person_manager())) {
+        return 1;
+    }
+    // The journal only makes sense on top of the state it was recorded
+    // against, so make the loaded workspace the new base right away.
+    if (get_journal().is_open() && !get_checkpointer().run()) {
+        return 1;
+    }
+    get_output() << "Workspace loaded from '" << path << "'.\n";
+    return 0;
+}
+
+// Prints how long a bulk transfer took and its rate.
+static void print_throughput(const char* verb, std::string_view path, std::uint64_t bytes,
+                             std::chrono::steady_clock::time_point start) {
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    get_output() << verb << " '" << path << "': " << bytes / 1e6 << " MB in " << seconds * 1e3 << " ms ("
+                 << (seconds > 0 ? bytes / 1e6 / seconds : 0) << " MB/s).\n";
+}
+
+static int export_command(CommandArgs args) {
+    if (args[0] != "json") {
+        std::cerr << "Error: Usage: export json <path>\n";
+        return 1;
+    }
+    auto start = std::chrono::steady_clock::now();
+    std::ofstream out(std::string(args[1]), std::ios::binary);
+    if (!out) {
+        std::cerr << "Error: Cannot create '" << args[1] << "'.\n";
+        return 1;
+    }
+    if (!export_json(out, get_task_manager(), get_person_manager())) {
+        return 1;
+    }
+    print_throughput("Exported", args[1], static_cast<std::uint64_t>(out.tellp()), start);
+    return 0;
+}
+
+static int import_command(CommandArgs args) {
+    if (args[0] != "json") {
+        std::cerr << "Error: Usage: import json <path>\n";
+        return 1;
+    }
+    std::ifstream in(std::string(args[1]), std::ios::binary);
+    if (!in) {
+        std::cerr << "Error: Cannot open '" << args[1] << "'.\n";
+        return 1;
+    }
+    // Make the snapshot current first: a failed import is rolled back by
+    // reloading it, and a successful one becomes the journal's new base.
+    if (!get_checkpointer().run()) {
+        return 1;
+    }
+    auto start = std::chrono::steady_clock::now();
+    if (!import_json(in, get_task_manager(), get_person_manager())) {
+        load_snapshot(snapshot_path, get_task_manager(), get_person_manager());
+        std::cerr << "Error: Import failed; the workspace was left as it was.\n";
+        return 1;
+    }
+    in.clear();
+    in.seekg(0, std::ios::end);
+    print_throughput("Imported", args[1], static_cast<std::uint64_t>(in.tellg()), start);
+    return get_checkpointer().run() ? 0 : 1;
+}
+
+static int checkpoint_command(CommandArgs args) {
+    Checkpointer& checkpointer = get_checkpointer();
+    if (!args.empty() && args[0] == "stats") {
+        const CheckpointStats& stats = checkpointer.get_stats();
+        int completed = std::max(stats.completed, 1);
+        get_output() << "Checkpoints: " << stats.completed << " completed, " << stats.failed << " failed"
+                     << (checkpointer.is_running() ? ", 1 running" : "") << "\n";
+        get_output() << "Duration (ms): last " << stats.last_duration_ms << ", max " << stats.max_duration_ms
+                     << ", avg " << stats.total_duration_ms / completed << "\n";
+        get_output() << "Stall (ms): last " << stats.last_stall_ms << ", max " << stats.max_stall_ms
+                     << ", avg " << stats.total_stall_ms / completed << "\n";
+        get_output() << "Last snapshot: " << stats.last_snapshot_bytes << " bytes up to LSN " << stats.last_lsn << "\n";
+        get_output() << "Journal: " << get_journal().get_size() << " bytes, last LSN " << get_journal().get_last_lsn() << "\n";
         return 0;
     }
-    
-    if (command == "add") {
-        if (args.size() < 2) {
-            std::cerr << "Error: Not enough arguments for 'add'. Use 'help' for usage.\n";
-            return 1;
-        }
-        std::cout << "Adding a new person...\n";
-        std::string name = args[1];
-        if (name.empty()) {
-            std::cerr << "Error: Name cannot be empty.\n";
-            return 1;
-        }
-        if (get_person_manager().add_person(name)) { // Add person using PersonManager
-            std::cout << "Person '" << name << "' added successfully.\n";
-        }
-    } else if (command == "list") {
-        PrintOptions options;
-        options.verbose = std::find(args.begin(), args.end(), "-v") != args.end();
-        std::cout << "Listing all people...\n";
-        get_person_manager().print_all_people(options); // Print all people using PersonManager
-    } else if (command == "rename") {
-        if (args.size() < 3) {
-            std::cerr << "Error: Not enough arguments for 'rename'. Use --help for usage.\n";
-            return 1;
-        }
-        std::string old_name = args[1];
-        std::string new_name = args[2];
-        if (new_name.empty()) {
-            std::cerr << "Error: New name cannot be empty.\n";
-            return 1;
-        }
-        if (get_person_manager().change_name(old_name, new_name)) {
-            std::cout << "Person '" << old_name << "' renamed to '" << new_name << "' successfully.\n";
-        } else {
-            std::cerr << "Error: Failed to rename person '" << old_name << "'.\n";
-        }
-    } else if (command == "delete") {
-        if (args.size() < 2) {
-            std::cerr << "Error: Not enough arguments for 'delete'. Use --help for usage.\n";
-            return 1;
-        }
-        std::string name = args[1];
-        if (get_person_manager().delete_person(name)) {
-            std::cout << "Person '" << name << "' deleted successfully.\n";
-        } else {
-            std::cerr << "Error: Failed to delete person '" << name << "'.\n";
-        }
-    } else if (command == "delete-all") {
-        get_person_manager().delete_all_people();
-        std::cout << "All people deleted successfully.\n";
-    } else if (command == "delete-tasks") {
-        if (args.size() < 2) {
-            std::cerr << "Error: Not enough arguments for 'delete-tasks'. Use --help for usage.\n";
-            return 1;
-        }
-        std::string name = args[1];
-        get_person_manager().delete_persons_all_tasks(name);
-    } else if (command == "assign-task") {
-        if (args.size() < 3) {
-            std::cerr << "Error: Not enough arguments for 'assign-task'. Use --help for usage.\n";
-            return 1;
-        }
-        std::string name = args[1];
-        int task_id = std::stoi(args[2]);
-        Task* task = get_task_manager().get_task(task_id);
-        if (task == nullptr) {
-            std::cerr << "Error: Task with ID " << task_id << " not found.\n";
-            return 1;
-        }
-        get_person_manager().assign_task(name, task);
-    } else if (command == "set-all-tasks-done") {
-        if (args.size() < 2) {
-            std::cerr << "Error: Not enough arguments for 'set-all-tasks-done'. Use --help for usage.\n";
-            return 1;
-        }
-        std::string name = args[1];
-        get_person_manager().set_persons_all_tasks_as_done(name);
-    } else if (command == "list-one") {
-        if (args.size() < 2) {
-            std::cerr << "Error: Not enough arguments for 'list-one'. Use --help for usage.\n";
-            return 1;
-        }
-        PrintOptions options;
-        options.verbose = std::find(args.begin(), args.end(), "-v") != args.end();
-        std::string name = args[1];
-        get_person_manager().print_person(name, options);
-    } else if (command == "list-tasks") {
-        if (args.size() < 2) {
-            std::cerr << "Error: Not enough arguments for 'list-tasks'. Use --help for usage.\n";
-            return 1;
-        }
-        PrintOptions options;
-        options.verbose = std::find(args.begin(), args.end(), "-v") != args.end();
-        options.nested = std::find(args.begin(), args.end(), "-n") != args.end();
-        std::string name = args[1];
-        get_person_manager().print_persons_tasks(name, options);
-    } else if (command == "list-tasks-count") {
-        bool nested = std::find(args.begin(), args.end(), "-n") != args.end();
-        get_person_manager().print_all_peoples_task_counts(nested);
+    if (!checkpointer.start()) {
+        std::cerr << "Error: A checkpoint is already running.\n";
+        return 1;
     }
+    get_output() << "Checkpoint started.\n";
+    return 0;
+}
+
+// --- Command tables ---
+// Dispatch and help both come from these, so a command cannot exist
+// without being documented or be documented without existing.
+
+static constexpr CommandTable task_commands(std::to_array<CommandSpec>({
+    {"help", "", "Show this help message", 0, task_help},
+    {"add", "-n <name> [-d <description>] [-o <owner>]", "Add a new task", 2, task_add},
+    {"list", "[-v:verbose] [-n:nested] [--format <format>]", "List all tasks", 0, task_list},
+    {"delete", "<task_id> [--recursive]", "Delete a task; its subtasks move up unless --recursive deletes them too", 1, task_delete},
+    {"complete", "<task_id>", "Mark a task as complete", 1, task_complete},
+    {"print", "<task_id> [-v:verbose] [-n:nested] [--format <format>]", "Print a task's details", 1, task_print},
+    {"assign", "<task_id> <person_name>", "Assign a task to a person", 2, task_assign},
+    {"unown", "<task_id>", "Unassign a task from its owner", 1, task_unown},
+    {"unown-all", "", "Unassign all tasks from their owners", 0, task_unown_all},
+    {"set-name", "<task_id> <new_name>", "Change the name of a task", 2, task_set_name},
+    {"set-description", "<task_id> <new_description>", "Change the description of a task", 2, task_set_description},
+    {"advance-status", "<task_id>", "Advance the status of a task", 1, task_advance_status},
+    {"mark-done", "<task_id>", "Mark a task as done", 1, task_mark_done},
+    {"make-child", "<parent_id> <child_id>", "Make a task a child of another task", 2, task_make_child},
+    {"move", "<task_id> <new_parent_id|none>", "Move a task and its subtree under another task", 2, task_move},
+    {"print-owners", "", "Print all task owners", 0, task_print_owners},
+    {"query", "<field><op><value>... [-v:verbose] [--count] [--format <format>]",
+     "List the tasks matching every term", 1, task_query},
+    {"search", "<word>... [-v:verbose] [--limit <n>] [--format <format>]",
+     "Find tasks by words in their name or description, best first", 1, task_search},
+    {"stats", "", "Print task counts per status", 0, task_stats},
+}));
 
+static constexpr CommandTable person_commands(std::to_array<CommandSpec>({
+    {"help", "", "Show this help message", 0, person_help},
+    {"add", "<name>", "Add a new person", 1, person_add},
+    {"list", "[-v:verbose] [--format <format>]", "List all people", 0, person_list},
+    {"rename", "<old-name> <new-name>", "Rename a person", 2, person_rename},
+    {"delete", "<name>", "Delete a person", 1, person_delete},
+    {"delete-all", "", "Delete all people", 0, person_delete_all},
+    {"delete-tasks", "<name>", "Delete all tasks assigned to a person", 1, person_delete_tasks},
+    {"assign-task", "<name> <task-id>", "Assign a task to a person", 2, person_assign_task},
+    {"set-all-tasks-done", "<name>", "Mark all tasks of a person as done", 1, person_set_all_tasks_done},
+    {"list-one", "<name> [-v:verbose] [--format <format>]", "List the details of one person", 1, person_list_one},
+    {"list-tasks", "<name> [-v:verbose] [-n:nested] [--format <format>]", "List all tasks of a person", 1, person_list_tasks},
+    {"list-tasks-count", "[-n:nested]", "List the task count of every person", 0, person_list_tasks_count},
+}));
+
+// Looks up args[0] in table and runs it with the rest of args.
+template <std::size_t N>
+static int run_entity_command(const CommandTable<N>& table, std::string_view entity, CommandArgs args) {
+    if (args.empty()) {
+        std::cerr << "Error: No command provided for '" << entity << "'. Use '" << entity << " help' for usage.\n";
+        return 1;
+    }
+    const CommandSpec* command = table.find(args[0]);
+    if (!command) {
+        std::cerr << "Error: Unknown " << entity << " command '" << args[0] << "'. Use '" << entity
+                  << " help' for usage.\n";
+        return 1;
+    }
+    args = args.subspan(1);
+    if (args.size() < command->min_args) {
+        std::cerr << "Error: Not enough arguments for '" << command->name << "'. Usage: " << entity << ' '
+                  << command->name << ' ' << command->usage << "\n";
+        return 1;
+    }
+    return command->run(args);
+}
+
+static void print_help();
+
+static int help_command(CommandArgs) {
+    print_help();
     return 0;
 }
 
-int main() {
-    std::string line;
+static int task_command(CommandArgs args) {
+    return run_entity_command(task_commands, "task", args);
+}
+
+static int person_command(CommandArgs args) {
+    return run_entity_command(person_commands, "person", args);
+}
 
-    std::cout << "Welcome to the Task Manager CLI Tool!\n";
-    std::cout << "Type 'help' for usage instructions.\n";
+static constexpr CommandTable global_commands(std::to_array<CommandSpec>({
+    {"help", "", "Show this help message", 0, help_command},
+    {"task", "<command> [options]", "Manage tasks ('task help' lists the commands)", 0, task_command},
+    {"person", "<command> [options]", "Manage people ('person help' lists the commands)", 0, person_command},
+    {"save", "[path]", "Write the workspace to a snapshot file", 0, save_command},
+    {"load", "[path]", "Replace the workspace with a snapshot file", 0, load_command},
+    {"checkpoint", "[stats]", "Fold the journal into the snapshot in the background, or show checkpoint timings",
+     0, checkpoint_command},
+    {"export", "json <path>", "Write the workspace as JSON", 2, export_command},
+    {"import", "json <path>", "Replace the workspace with a JSON export", 2, import_command},
+}));
 
+// --- Help ---
+
+// One line per command: "name usage", padded to a common column, then the summary.
+template <std::size_t N>
+static void print_commands(const CommandTable<N>& table) {
+    OutputSink& out = get_output();
+    const std::size_t column = table.usage_width() + 4;
+    for (const CommandSpec& command : table) {
+        out << "  " << command.name;
+        std::size_t width = command.name.size();
+        if (!command.usage.empty()) {
+            out << ' ' << command.usage;
+            width += 1 + command.usage.size();
+        }
+        for (; width < column; ++width) out << ' ';
+        out << command.summary << '\n';
+    }
+}
+
+static void print_help() {
+    OutputSink& out = get_output();
+    out << "taskcli - Task Manager CLI Tool\n\n";
+    out << "Usage:\n";
+    out << "  taskcli <command> [arguments]\n\n";
+    out << "Commands:\n";
+    print_commands(global_commands);
+    out << "\nStartup Options:\n";
+    out << "  --batch <file>       Run the commands in file without prompts and exit;\n";
+    out << "                       also used when stdin is not a terminal\n";
+    out << "  --snapshot <path>    Snapshot file to load at startup and save to\n";
+    out << "                       (default: taskcli.snapshot)\n";
+    out << "  --fsync <policy>     When journaled changes reach the disk:\n";
+    out << "                       command (default), group or none\n";
+    out << "  --group-commit-ms <n>  Sync interval for --fsync group (default: 10)\n";
+    out << "  --checkpoint-bytes <n>    Checkpoint once the journal reaches n bytes\n";
+    out << "                            (default: 67108864, 0 = never)\n";
+    out << "  --checkpoint-seconds <n>  Checkpoint n seconds after the last one\n";
+    out << "                            (default: 300, 0 = never)\n";
+}
+
+static void print_task_help() {
+    OutputSink& out = get_output();
+    out << "taskcli task - Manage tasks\n\n";
+    out << "Usage:\n";
+    out << "  taskcli task <command> [options]\n\n";
+    out << "Commands:\n";
+    print_commands(task_commands);
+    out << "\n<format> is text (the default), or jsonl, csv or tsv for one record per line.\n";
+    out << "Query terms compare status, owner, level, parent or id with =, !=, <, <=, > or >=,\n";
+    out << "e.g. 'task query status=InProgress owner=alice level<=2'; 'none' means no owner or parent.\n";
+    out << "'under=<id>' matches every task below that task, at any depth.\n";
+    out << "Search words match case-insensitively, also inside longer words from three letters on;\n";
+    out << "the --limit best matches are shown (default 20, 0 = all).\n";
+}
+
+static void print_person_help() {
+    OutputSink& out = get_output();
+    out << "taskcli person - Manage people\n\n";
+    out << "Usage:\n";
+    out << "  taskcli person <command> [options]\n\n";
+    out << "Commands:\n";
+    print_commands(person_commands);
+    out << "\n<format> is text (the default), or jsonl, csv or tsv for one record per line.\n";
+}
+
+// Runs one command line. Returns false if it asks to exit.
+bool run_command_line(std::string_view line) {
+    if (line == "exit" || line == "quit") {
+        return false;
+    }
+
+    // The tokens are views into the tokenizer, which is reused so that a
+    // command costs no allocations just to be split up.
+    static CommandTokenizer tokenizer;
+    std::span<const std::string_view> tokens = tokenizer.tokenize(line);
+    std::string_view name = tokens.empty() ? std::string_view() : tokens[0];
+    CommandArgs args = tokens.empty() ? tokens : tokens.subspan(1);
+
+    const CommandSpec* command = global_commands.find(name);
+    if (!command) {
+        std::cerr << "Error: Unknown command '" << name << "'. Type 'help' for usage instructions.\n";
+    } else if (args.size() < command->min_args) {
+        std::cerr << "Error: Not enough arguments for '" << name << "'. Usage: " << name << ' '
+                  << command->usage << "\n";
+    } else {
+        command->run(args);
+    }
+    get_checkpointer().poll();
+    get_output().flush();  // Once per command, not per line
+    return true;
+}
+
+void run_interactive() {
+    OutputSink& out = get_output();
+    out << "Welcome to the Task Manager CLI Tool!\n";
+    out << "Type 'help' for usage instructions.\n";
+
+    std::string line;
     while (true) {
-        std::cout << "> ";
-        std::getline(std::cin, line);
+        out << "> ";
+        out.flush();  // std::cin is tied to std::cout, which flushes the prompt
+        if (!std::getline(std::cin, line)) {
+            out << "\n";
+            break;  // End of input
+        }
         if (line.empty()) continue;
-
-        // Exit command
-        if (line == "exit" || line == "quit") {
-            std::cout << "Exiting the Task Manager CLI Tool. Goodbye!\n";
+        if (!run_command_line(line)) {
+            out << "Exiting the Task Manager CLI Tool. Goodbye!\n";
             break;
         }
+    }
+    out << "Goodbye.\n";
+    out.flush();
+}
 
-         // Parse and handle command
-        std::istringstream iss(line);
-        std::string command;
-        iss >> command;
+// Runs a script (path, or stdin if empty) without prompts or banners. Output
+// is block-buffered rather than flushed per line, and a summary goes to
+// stderr at the end. Blank lines and lines starting with '#' are skipped.
+// Returns false if the script cannot be read.
+bool run_batch(const std::string& path) {
+    int fd = path.empty() ? STDIN_FILENO : ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error: Cannot open batch file '" << path << "'.\n";
+        return false;
+    }
 
-        // Collect remaining tokens into a vector
-        std::vector<std::string> args;
-        std::string arg;
-        while (iss >> std::quoted(arg)) {
-            args.push_back(arg);
-        }
+    auto start = std::chrono::steady_clock::now();
+    std::uint64_t commands = 0;
+    LineReader reader(fd);
+    std::string_view line;
+    while (reader.next(line)) {
+        size_t first = line.find_first_not_of(" \t");
+        if (first == std::string_view::npos || line[first] == '#') continue;
+        ++commands;
+        if (!run_command_line(line)) break;
+    }
+    get_output().flush();
+    std::cout.flush();
+    if (fd != STDIN_FILENO) ::close(fd);
+    if (reader.failed()) {
+        std::cerr << "Error: Failed to read the batch input.\n";
+        return false;
+    }
 
-        std::vector<const char*> argv_like;
-        for (const auto& a : args) {
-            argv_like.push_back(a.c_str());
-        }
-        int argc = argv_like.size(); // +1 for the command itself
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << "Batch: " << commands << " commands in " << seconds * 1e3 << " ms ("
+              << (seconds > 0 ? commands / seconds : 0) << " commands/s).\n";
+    return true;
+}
 
-        if (command == "help") {
-            print_help();
-            continue;
-        }
-        if (command == "task") {
-            handle_task_command(args);
-        } else if (command == "person") {
-            handle_person_command(args);
+int main(int argc, char** argv) {
+    std::string batch_path;
+    FsyncPolicy fsync_policy = FsyncPolicy::PerCommand;
+    int group_commit_ms = 10;
+    std::uint64_t checkpoint_bytes = 64ull << 20;
+    int checkpoint_seconds = 300;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view option = argv[i];
+        if (option == "--snapshot" && i + 1 < argc) {
+            snapshot_path = argv[++i];
+        } else if (option == "--batch" && i + 1 < argc) {
+            batch_path = argv[++i];
+        } else if (option == "--fsync" && i + 1 < argc) {
+            std::string_view value = argv[++i];
+            if (value == "command") {
+                fsync_policy = FsyncPolicy::PerCommand;
+            } else if (value == "group") {
+                fsync_policy = FsyncPolicy::Group;
+            } else if (value == "none") {
+                fsync_policy = FsyncPolicy::None;
+            } else {
+                std::cerr << "Error: Unknown fsync policy '" << value << "'.\n";
+                return 1;
+            }
+        } else if (option == "--group-commit-ms" && i + 1 < argc) {
+            std::string_view value = argv[++i];
+            if (!parse_int(value, group_commit_ms) || group_commit_ms <= 0) {
+                std::cerr << "Error: --group-commit-ms takes a positive number of milliseconds, not '" << value << "'.\n";
+                return 1;
+            }
+        } else if (option == "--checkpoint-bytes" && i + 1 < argc) {
+            std::string_view value = argv[++i];
+            if (!parse_uint64(value, checkpoint_bytes)) {
+                std::cerr << "Error: --checkpoint-bytes takes a byte count (0 = never), not '" << value << "'.\n";
+                return 1;
+            }
+        } else if (option == "--checkpoint-seconds" && i + 1 < argc) {
+            std::string_view value = argv[++i];
+            if (!parse_int(value, checkpoint_seconds) || checkpoint_seconds < 0) {
+                std::cerr << "Error: --checkpoint-seconds takes a number of seconds (0 = never), not '" << value << "'.\n";
+                return 1;
+            }
         } else {
-            std::cerr << "Error: Unknown command '" << command << "'. Type 'help' for usage instructions.\n";
+            std::cerr << "Error: Unknown option '" << option << "'.\n";
+            return 1;
         }
     }
 
-    std::cout << "Goodbye.\n";
+    // Recover: latest snapshot first, then the journaled changes made after it.
+    std::uint64_t snapshot_lsn = 0;
+    struct stat snapshot_stat;
+    if (::stat(snapshot_path.c_str(), &snapshot_stat) == 0
+        && !load_snapshot(snapshot_path, get_task_manager(), get_person_manager(), &snapshot_lsn)) {
+        std::cerr << "Error: Refusing to start on top of an unreadable snapshot.\n";
+        return 1;
+    }
+    get_journal().set_fsync_policy(fsync_policy, group_commit_ms);
+    if (!get_journal().open(snapshot_path + ".journal", get_task_manager(), get_person_manager(), snapshot_lsn)) {
+        return 1;
+    }
+    get_checkpointer().set_snapshot_path(snapshot_path);
+    get_checkpointer().set_thresholds(checkpoint_bytes, checkpoint_seconds);
+
+    if (batch_path.empty() && ::isatty(STDIN_FILENO)) {
+        run_interactive();
+    } else if (!run_batch(batch_path)) {
+        return 1;
+    }
+    get_checkpointer().wait();
     return 0;
 }
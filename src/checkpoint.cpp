@@ -0,0 +1,114 @@
+#include "checkpoint.hpp"
+#include "journal.hpp"
+#include "person_manager.hpp"
+#include "snapshot.hpp"
+#include "task_manager.hpp"
+
+#include <algorithm>
+
+namespace {
+
+double milliseconds(std::chrono::steady_clock::duration elapsed) {
+    return std::chrono::duration<double, std::milli>(elapsed).count();
+}
+
+} // namespace
+
+Checkpointer::Checkpointer(TaskManager& task_manager, PersonManager& person_manager, Journal& journal)
+    : task_manager(task_manager), person_manager(person_manager), journal(journal) {}
+
+Checkpointer::~Checkpointer() {
+    wait();
+}
+
+void Checkpointer::set_snapshot_path(const std::string& path) {
+    snapshot_path = path;
+}
+
+void Checkpointer::set_thresholds(std::uint64_t journal_bytes, int interval_seconds) {
+    threshold_bytes = journal_bytes;
+    threshold_seconds = interval_seconds;
+}
+
+void Checkpointer::poll() {
+    if (worker.joinable()) {
+        if (!worker_done.load(std::memory_order_acquire)) return;
+        collect();
+    }
+    if (!journal.is_open() || journal.get_size() <= sizeof(JournalHeader)) return;
+    bool too_big = threshold_bytes > 0 && journal.get_size() >= threshold_bytes;
+    bool too_old = threshold_seconds > 0 && Clock::now() - last_checkpoint >= std::chrono::seconds(threshold_seconds);
+    if (too_big || too_old) {
+        start();
+    }
+}
+
+int Checkpointer::start() {
+    if (worker.joinable()) {
+        if (!worker_done.load(std::memory_order_acquire)) return 0;
+        collect();
+    }
+    worker_started = Clock::now();
+    worker_lsn = journal.get_last_lsn();
+    std::vector<char> image = encode_snapshot(task_manager, person_manager, worker_lsn);
+    worker_bytes = image.size();
+    journal.rotate();
+    worker_stall_ms = milliseconds(Clock::now() - worker_started);
+
+    worker_done.store(false, std::memory_order_relaxed);
+    worker = std::thread(&Checkpointer::write_in_background, this, std::move(image));
+    return 1;
+}
+
+int Checkpointer::run() {
+    wait();
+    auto started = Clock::now();
+    std::uint64_t lsn = journal.get_last_lsn();
+    std::vector<char> image = encode_snapshot(task_manager, person_manager, lsn);
+    bool ok = write_snapshot_file(snapshot_path, image);
+    if (ok && journal.is_open()) {
+        ok = journal.truncate();
+        journal.drop_rotated();
+    }
+    double duration_ms = milliseconds(Clock::now() - started);
+    record(ok, duration_ms, duration_ms, image.size(), lsn);
+    return ok ? 1 : 0;
+}
+
+void Checkpointer::wait() {
+    if (worker.joinable()) {
+        collect();
+    }
+}
+
+void Checkpointer::write_in_background(std::vector<char> image) {
+    worker_ok = write_snapshot_file(snapshot_path, image);
+    if (worker_ok) {
+        // The snapshot now holds every record up to worker_lsn.
+        journal.drop_rotated();
+    }
+    worker_finished = Clock::now();
+    worker_done.store(true, std::memory_order_release);
+}
+
+void Checkpointer::collect() {
+    worker.join();
+    record(worker_ok, milliseconds(worker_finished - worker_started), worker_stall_ms, worker_bytes, worker_lsn);
+}
+
+void Checkpointer::record(bool ok, double duration_ms, double stall_ms, std::uint64_t bytes, std::uint64_t lsn) {
+    last_checkpoint = Clock::now();
+    if (!ok) {
+        ++stats.failed;
+        return;
+    }
+    ++stats.completed;
+    stats.last_duration_ms = duration_ms;
+    stats.max_duration_ms = std::max(stats.max_duration_ms, duration_ms);
+    stats.total_duration_ms += duration_ms;
+    stats.last_stall_ms = stall_ms;
+    stats.max_stall_ms = std::max(stats.max_stall_ms, stall_ms);
+    stats.total_stall_ms += stall_ms;
+    stats.last_snapshot_bytes = bytes;
+    stats.last_lsn = lsn;
+}
@@ -0,0 +1,40 @@
+#include "command_tokenizer.hpp"
+
+namespace {
+
+bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+} // namespace
+
+std::span<const std::string_view> CommandTokenizer::tokenize(std::string_view line) {
+    buffer.assign(line);
+    tokens.clear();
+    char* data = buffer.data();
+    size_t size = buffer.size();
+    size_t i = 0;
+    while (true) {
+        while (i < size && is_space(data[i])) ++i;
+        if (i == size) break;
+
+        size_t start = i;
+        if (data[i] != '"') {
+            while (i < size && !is_space(data[i])) ++i;
+            tokens.emplace_back(data + start, i - start);
+            continue;
+        }
+
+        // Quoted: drop the escaping backslashes by shifting the rest of the
+        // token left. The write position never passes the read position.
+        start = ++i;
+        size_t end = start;
+        while (i < size && data[i] != '"') {
+            if (data[i] == '\\' && i + 1 < size) ++i;
+            data[end++] = data[i++];
+        }
+        tokens.emplace_back(data + start, end - start);
+        if (i < size) ++i;  // Closing quote; an unterminated token ends with the line
+    }
+    return tokens;
+}
@@ -0,0 +1,349 @@
+#include "id_bitmap.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <iterator>
+#include <utility>
+
+namespace {
+
+// Set bits across words(0) .. words(count - 1), where count is a multiple
+// of 16. With POPCNT available
+// (e.g. -march=native) this is one instruction per word, which the compiler
+// also vectorizes where the target has a vector popcount. Otherwise a
+// portable popcount would be a library call per word, so the bits are
+// counted per byte instead, 16 words at a time: plain shifts, masks and adds
+// that vectorize on any x86-64 or AArch64 target.
+template <typename Words>
+std::size_t popcount_words(Words words, std::size_t count) {
+    std::size_t total = 0;
+#if defined(__POPCNT__)
+    for (std::size_t i = 0; i < count; ++i) {
+        total += std::popcount(words(i));
+    }
+#else
+    constexpr std::uint64_t m1 = 0x5555555555555555ULL, m2 = 0x3333333333333333ULL;
+    constexpr std::uint64_t m4 = 0x0F0F0F0F0F0F0F0FULL, m8 = 0x00FF00FF00FF00FFULL;
+    for (std::size_t i = 0; i < count; i += 16) {
+        std::uint64_t bytes = 0;  // Eight per-byte counts, at most 16 * 8 each
+        for (std::size_t k = i; k < i + 16; ++k) {
+            std::uint64_t x = words(k);
+            x -= (x >> 1) & m1;
+            x = (x & m2) + ((x >> 2) & m2);
+            bytes += (x + (x >> 4)) & m4;
+        }
+        bytes = (bytes & m8) + ((bytes >> 8) & m8);
+        bytes += bytes >> 16;
+        bytes += bytes >> 32;
+        total += bytes & 0xFFFF;
+    }
+#endif
+    return total;
+}
+
+bool test_bit(const std::vector<std::uint64_t>& bits, std::uint16_t low) {
+    return bits[low >> 6] >> (low & 63) & 1;
+}
+
+} // namespace
+
+bool IdBitmap::contains_low(const Chunk& chunk, std::uint16_t low) {
+    if (chunk.dense()) return test_bit(chunk.bits, low);
+    return std::binary_search(chunk.array.begin(), chunk.array.end(), low);
+}
+
+std::vector<IdBitmap::Chunk>::iterator IdBitmap::find_chunk(std::uint16_t key) {
+    return std::lower_bound(chunks.begin(), chunks.end(), key,
+                            [](const Chunk& chunk, std::uint16_t k) { return chunk.key < k; });
+}
+
+std::vector<IdBitmap::Chunk>::const_iterator IdBitmap::find_chunk(std::uint16_t key) const {
+    return std::lower_bound(chunks.begin(), chunks.end(), key,
+                            [](const Chunk& chunk, std::uint16_t k) { return chunk.key < k; });
+}
+
+void IdBitmap::to_bitset(Chunk& chunk) {
+    chunk.bits.assign(bitset_words, 0);
+    for (std::uint16_t low : chunk.array) {
+        chunk.bits[low >> 6] |= std::uint64_t{1} << (low & 63);
+    }
+    chunk.array = std::vector<std::uint16_t>();
+}
+
+void IdBitmap::to_array(Chunk& chunk) {
+    std::vector<std::uint16_t> array;
+    array.reserve(chunk.count);
+    for (std::uint32_t w = 0; w < bitset_words; ++w) {
+        for (std::uint64_t word = chunk.bits[w]; word; word &= word - 1) {
+            array.push_back(static_cast<std::uint16_t>((w << 6) | std::countr_zero(word)));
+        }
+    }
+    chunk.array = std::move(array);
+    chunk.bits = std::vector<std::uint64_t>();
+}
+
+void IdBitmap::normalize(Chunk& chunk) {
+    if (chunk.dense() && chunk.count < array_floor) {
+        to_array(chunk);
+    } else if (!chunk.dense() && chunk.count > array_limit) {
+        to_bitset(chunk);
+    }
+}
+
+void IdBitmap::recount() {
+    cardinality = 0;
+    for (const Chunk& chunk : chunks) cardinality += chunk.count;
+}
+
+// IDs arriving in ascending order, as in a bulk load, land in the last
+// chunk and at the end of its array, so both searches are skipped for them.
+bool IdBitmap::insert(std::uint32_t id) {
+    std::uint16_t key = static_cast<std::uint16_t>(id >> 16), low = static_cast<std::uint16_t>(id);
+    auto chunk = !chunks.empty() && chunks.back().key == key ? chunks.end() - 1
+               : !chunks.empty() && chunks.back().key < key ? chunks.end()
+               : find_chunk(key);
+    if (chunk == chunks.end() || chunk->key != key) {
+        chunk = chunks.insert(chunk, Chunk{key, 0, {}, {}});
+    }
+    if (chunk->dense()) {
+        std::uint64_t& word = chunk->bits[low >> 6];
+        std::uint64_t bit = std::uint64_t{1} << (low & 63);
+        if (word & bit) return false;
+        word |= bit;
+    } else if (chunk->array.empty() || chunk->array.back() < low) {
+        chunk->array.push_back(low);
+    } else {
+        auto at = std::lower_bound(chunk->array.begin(), chunk->array.end(), low);
+        if (at != chunk->array.end() && *at == low) return false;
+        chunk->array.insert(at, low);
+    }
+    ++chunk->count;
+    ++cardinality;
+    normalize(*chunk);
+    return true;
+}
+
+bool IdBitmap::erase(std::uint32_t id) {
+    std::uint16_t key = static_cast<std::uint16_t>(id >> 16), low = static_cast<std::uint16_t>(id);
+    auto chunk = find_chunk(key);
+    if (chunk == chunks.end() || chunk->key != key) return false;
+    if (chunk->dense()) {
+        std::uint64_t& word = chunk->bits[low >> 6];
+        std::uint64_t bit = std::uint64_t{1} << (low & 63);
+        if (!(word & bit)) return false;
+        word &= ~bit;
+    } else {
+        auto at = std::lower_bound(chunk->array.begin(), chunk->array.end(), low);
+        if (at == chunk->array.end() || *at != low) return false;
+        chunk->array.erase(at);
+    }
+    --cardinality;
+    if (--chunk->count == 0) {
+        chunks.erase(chunk);
+    } else {
+        normalize(*chunk);
+    }
+    return true;
+}
+
+bool IdBitmap::contains(std::uint32_t id) const {
+    std::uint16_t key = static_cast<std::uint16_t>(id >> 16);
+    auto chunk = find_chunk(key);
+    return chunk != chunks.end() && chunk->key == key && contains_low(*chunk, static_cast<std::uint16_t>(id));
+}
+
+void IdBitmap::clear() {
+    chunks = std::vector<Chunk>();
+    cardinality = 0;
+}
+
+void IdBitmap::assign_sorted(std::span<const std::int32_t> ids) {
+    clear();
+    for (std::size_t begin = 0, end; begin < ids.size(); begin = end) {
+        std::uint16_t key = static_cast<std::uint16_t>(static_cast<std::uint32_t>(ids[begin]) >> 16);
+        for (end = begin + 1; end < ids.size() && static_cast<std::uint32_t>(ids[end]) >> 16 == key; ++end) {}
+        Chunk& chunk = chunks.emplace_back(Chunk{key, static_cast<std::uint32_t>(end - begin), {}, {}});
+        if (chunk.count > array_limit) {
+            chunk.bits.assign(bitset_words, 0);
+            for (std::size_t i = begin; i < end; ++i) {
+                std::uint16_t low = static_cast<std::uint16_t>(ids[i]);
+                chunk.bits[low >> 6] |= std::uint64_t{1} << (low & 63);
+            }
+        } else {
+            chunk.array.reserve(chunk.count);
+            for (std::size_t i = begin; i < end; ++i) chunk.array.push_back(static_cast<std::uint16_t>(ids[i]));
+        }
+    }
+    cardinality = ids.size();
+}
+
+IdBitmap& IdBitmap::operator&=(const IdBitmap& other) {
+    auto out = chunks.begin();
+    auto theirs = other.chunks.begin();
+    for (Chunk& chunk : chunks) {
+        theirs = std::lower_bound(theirs, other.chunks.end(), chunk.key,
+                                  [](const Chunk& c, std::uint16_t k) { return c.key < k; });
+        if (theirs == other.chunks.end() || theirs->key != chunk.key) continue;
+        if (chunk.dense() && theirs->dense()) {
+            for (std::uint32_t w = 0; w < bitset_words; ++w) chunk.bits[w] &= theirs->bits[w];
+            chunk.count = static_cast<std::uint32_t>(
+                popcount_words([&](std::size_t w) { return chunk.bits[w]; }, bitset_words));
+        } else if (chunk.dense()) {
+            std::vector<std::uint16_t> kept;
+            for (std::uint16_t low : theirs->array) {
+                if (test_bit(chunk.bits, low)) kept.push_back(low);
+            }
+            chunk.array = std::move(kept);
+            chunk.bits = std::vector<std::uint64_t>();
+            chunk.count = static_cast<std::uint32_t>(chunk.array.size());
+        } else {
+            std::erase_if(chunk.array, [&](std::uint16_t low) { return !contains_low(*theirs, low); });
+            chunk.count = static_cast<std::uint32_t>(chunk.array.size());
+        }
+        if (chunk.count == 0) continue;
+        normalize(chunk);
+        if (&*out != &chunk) *out = std::move(chunk);
+        ++out;
+    }
+    chunks.erase(out, chunks.end());
+    recount();
+    return *this;
+}
+
+IdBitmap& IdBitmap::operator|=(const IdBitmap& other) {
+    std::vector<Chunk> merged;
+    merged.reserve(chunks.size() + other.chunks.size());
+    auto mine = chunks.begin();
+    auto theirs = other.chunks.begin();
+    while (mine != chunks.end() || theirs != other.chunks.end()) {
+        if (theirs == other.chunks.end() || (mine != chunks.end() && mine->key < theirs->key)) {
+            merged.push_back(std::move(*mine++));
+            continue;
+        }
+        if (mine == chunks.end() || theirs->key < mine->key) {
+            merged.push_back(*theirs++);
+            continue;
+        }
+        Chunk& chunk = *mine;
+        if (chunk.dense() || theirs->dense()) {
+            if (!chunk.dense()) to_bitset(chunk);
+            if (theirs->dense()) {
+                for (std::uint32_t w = 0; w < bitset_words; ++w) chunk.bits[w] |= theirs->bits[w];
+            } else {
+                for (std::uint16_t low : theirs->array) chunk.bits[low >> 6] |= std::uint64_t{1} << (low & 63);
+            }
+            chunk.count = static_cast<std::uint32_t>(
+                popcount_words([&](std::size_t w) { return chunk.bits[w]; }, bitset_words));
+        } else {
+            std::vector<std::uint16_t> both;
+            both.reserve(chunk.array.size() + theirs->array.size());
+            std::set_union(chunk.array.begin(), chunk.array.end(), theirs->array.begin(), theirs->array.end(),
+                           std::back_inserter(both));
+            chunk.array = std::move(both);
+            chunk.count = static_cast<std::uint32_t>(chunk.array.size());
+        }
+        normalize(chunk);
+        merged.push_back(std::move(chunk));
+        ++mine;
+        ++theirs;
+    }
+    chunks = std::move(merged);
+    recount();
+    return *this;
+}
+
+IdBitmap& IdBitmap::operator-=(const IdBitmap& other) {
+    auto out = chunks.begin();
+    auto theirs = other.chunks.begin();
+    for (Chunk& chunk : chunks) {
+        theirs = std::lower_bound(theirs, other.chunks.end(), chunk.key,
+                                  [](const Chunk& c, std::uint16_t k) { return c.key < k; });
+        if (theirs != other.chunks.end() && theirs->key == chunk.key) {
+            if (chunk.dense() && theirs->dense()) {
+                for (std::uint32_t w = 0; w < bitset_words; ++w) chunk.bits[w] &= ~theirs->bits[w];
+                chunk.count = static_cast<std::uint32_t>(
+                    popcount_words([&](std::size_t w) { return chunk.bits[w]; }, bitset_words));
+            } else if (chunk.dense()) {
+                for (std::uint16_t low : theirs->array) {
+                    std::uint64_t bit = std::uint64_t{1} << (low & 63);
+                    chunk.count -= (chunk.bits[low >> 6] & bit) != 0;
+                    chunk.bits[low >> 6] &= ~bit;
+                }
+            } else {
+                std::erase_if(chunk.array, [&](std::uint16_t low) { return contains_low(*theirs, low); });
+                chunk.count = static_cast<std::uint32_t>(chunk.array.size());
+            }
+            if (chunk.count == 0) continue;
+            normalize(chunk);
+        }
+        if (&*out != &chunk) *out = std::move(chunk);
+        ++out;
+    }
+    chunks.erase(out, chunks.end());
+    recount();
+    return *this;
+}
+
+std::size_t IdBitmap::and_count(const Chunk& a, const Chunk& b) {
+    if (a.dense() && b.dense()) {
+        return popcount_words([&](std::size_t w) { return a.bits[w] & b.bits[w]; }, bitset_words);
+    }
+    if (a.dense() || b.dense()) {
+        const Chunk& sparse = a.dense() ? b : a;
+        const Chunk& dense = a.dense() ? a : b;
+        std::size_t count = 0;
+        for (std::uint16_t low : sparse.array) count += test_bit(dense.bits, low);
+        return count;
+    }
+    std::size_t count = 0;
+    auto x = a.array.begin(), y = b.array.begin();
+    while (x != a.array.end() && y != b.array.end()) {
+        if (*x < *y) {
+            ++x;
+        } else if (*y < *x) {
+            ++y;
+        } else {
+            ++count;
+            ++x;
+            ++y;
+        }
+    }
+    return count;
+}
+
+std::size_t IdBitmap::and_count(const IdBitmap& a, const IdBitmap& b) {
+    std::size_t count = 0;
+    auto x = a.chunks.begin(), y = b.chunks.begin();
+    while (x != a.chunks.end() && y != b.chunks.end()) {
+        if (x->key < y->key) {
+            ++x;
+        } else if (y->key < x->key) {
+            ++y;
+        } else {
+            count += and_count(*x++, *y++);
+        }
+    }
+    return count;
+}
+
+std::size_t IdBitmap::and_not_count(const IdBitmap& a, const IdBitmap& b) {
+    return a.count() - and_count(a, b);
+}
+
+bool IdBitmap::operator==(const IdBitmap& other) const {
+    if (cardinality != other.cardinality || chunks.size() != other.chunks.size()) return false;
+    for (std::size_t i = 0; i < chunks.size(); ++i) {
+        const Chunk& a = chunks[i];
+        const Chunk& b = other.chunks[i];
+        if (a.key != b.key || a.count != b.count || and_count(a, b) != a.count) return false;
+    }
+    return true;
+}
+
+std::size_t IdBitmap::memory_bytes() const {
+    std::size_t bytes = chunks.capacity() * sizeof(Chunk);
+    for (const Chunk& chunk : chunks) {
+        bytes += chunk.array.capacity() * sizeof(std::uint16_t) + chunk.bits.capacity() * sizeof(std::uint64_t);
+    }
+    return bytes;
+}
@@ -0,0 +1,426 @@
+#include "journal.hpp"
+#include "person.hpp"
+#include "person_manager.hpp"
+#include "snapshot.hpp"
+#include "task.hpp"
+#include "task_manager.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+bool write_all(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+bool read_all(int fd, std::vector<char>& out, size_t size) {
+    out.resize(size);
+    size_t done = 0;
+    while (done < size) {
+        ssize_t got = ::pread(fd, out.data() + done, size - done, static_cast<off_t>(done));
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) return false;
+        done += static_cast<size_t>(got);
+    }
+    return true;
+}
+
+bool write_header(int fd) {
+    JournalHeader header{};
+    std::memcpy(header.magic, journal_magic, sizeof(header.magic));
+    header.version = journal_version;
+    return ::ftruncate(fd, 0) == 0
+        && write_all(fd, reinterpret_cast<const char*>(&header), sizeof(header))
+        && ::fsync(fd) == 0;
+}
+
+// Returns why contents is not a journal, or nullptr if its header is fine.
+const char* check_header(const std::vector<char>& contents) {
+    JournalHeader header;
+    if (contents.size() < sizeof(header)) return "is truncated";
+    std::memcpy(&header, contents.data(), sizeof(header));
+    if (std::memcmp(header.magic, journal_magic, sizeof(header.magic)) != 0) return "has a bad magic";
+    if (header.version != journal_version) return "has an unsupported version";
+    return nullptr;
+}
+
+std::uint32_t record_checksum(const char* lsn_and_payload, size_t size) {
+    return static_cast<std::uint32_t>(snapshot_checksum(lsn_and_payload, size));
+}
+
+// Bounds-checked cursor over one record's fields.
+class FieldReader {
+public:
+    FieldReader(const char* data, size_t size) : data(data), end(data + size) {}
+
+    bool read(int& value) {
+        std::uint32_t raw;
+        if (end - data < 4) return false;
+        std::memcpy(&raw, data, 4);
+        data += 4;
+        value = static_cast<int>(raw);
+        return true;
+    }
+
+    bool read(std::string_view& value) {
+        int length;
+        if (!read(length) || static_cast<std::uint32_t>(length) > static_cast<size_t>(end - data)) return false;
+        value = std::string_view(data, static_cast<std::uint32_t>(length));
+        data += value.size();
+        return true;
+    }
+
+    template <typename... Fields>
+    bool read_all(Fields&... fields) {
+        return (read(fields) && ...) && data == end;
+    }
+
+private:
+    const char* data;
+    const char* end;
+};
+
+// Re-applies one logged mutation through the same manager calls the command
+// made. Returns false if the payload does not decode.
+bool apply_record(JournalOp op, FieldReader in, TaskManager& task_manager, PersonManager& person_manager) {
+    int id = 0, other_id = 0;
+    std::string_view name, text, owner_name;
+    switch (op) {
+    case JournalOp::TaskAdd: {
+        if (!in.read_all(id, name, text, owner_name)) return false;
+        Person* owner = owner_name.empty() ? nullptr : person_manager.find_person_by_name(owner_name);
+        task_manager.restore_task(id, name, text, Task::Status::Todo, owner);
+        return true;
+    }
+    case JournalOp::TaskDelete:
+        if (!in.read_all(id)) return false;
+        task_manager.delete_task(id);
+        return true;
+    case JournalOp::TaskSetStatus: {
+        if (!in.read_all(id, other_id) || other_id < 0 || other_id >= Task::status_count) return false;
+        Task* task = task_manager.get_task(id);
+        if (task) task->set_status(static_cast<Task::Status>(other_id));
+        return true;
+    }
+    case JournalOp::TaskSetOwner: {
+        if (!in.read_all(id, owner_name)) return false;
+        Task* task = task_manager.get_task(id);
+        if (task) task->set_owner(owner_name.empty() ? nullptr : person_manager.find_person_by_name(owner_name));
+        return true;
+    }
+    case JournalOp::TaskUnownAll:
+        if (!in.read_all()) return false;
+        task_manager.unown_all_tasks();
+        return true;
+    case JournalOp::TaskSetName:
+        if (!in.read_all(id, name)) return false;
+        task_manager.set_task_name(id, std::string(name));
+        return true;
+    case JournalOp::TaskSetDescription:
+        if (!in.read_all(id, text)) return false;
+        task_manager.set_task_description(id, std::string(text));
+        return true;
+    case JournalOp::TaskMakeChild:
+        if (!in.read_all(id, other_id)) return false;
+        task_manager.make_child_task(id, other_id);
+        return true;
+    case JournalOp::TaskMove:
+        if (!in.read_all(id, other_id)) return false;
+        task_manager.move_task(id, other_id);
+        return true;
+    case JournalOp::TaskDeleteSubtree:
+        if (!in.read_all(id)) return false;
+        task_manager.delete_subtree(id);
+        return true;
+    case JournalOp::PersonAdd:
+        if (!in.read_all(name)) return false;
+        person_manager.add_person(name);
+        return true;
+    case JournalOp::PersonRename:
+        if (!in.read_all(name, text)) return false;
+        person_manager.change_name(name, text);
+        return true;
+    case JournalOp::PersonDelete:
+        if (!in.read_all(name)) return false;
+        person_manager.delete_person(name);
+        return true;
+    case JournalOp::PersonDeleteAll:
+        if (!in.read_all()) return false;
+        person_manager.delete_all_people();
+        return true;
+    case JournalOp::PersonDeleteTasks: {
+        if (!in.read_all(name)) return false;
+        Person* person = person_manager.find_person_by_name(name);
+        if (person) task_manager.delete_tasks_owned_by(person);
+        return true;
+    }
+    case JournalOp::PersonSetAllTasksDone:
+        if (!in.read_all(name)) return false;
+        person_manager.set_persons_all_tasks_as_done(name);
+        return true;
+    }
+    return false;  // Unknown op
+}
+
+} // namespace
+
+Journal::~Journal() {
+    close();
+}
+
+void Journal::set_fsync_policy(FsyncPolicy new_policy, int new_group_commit_ms) {
+    policy = new_policy;
+    group_commit_ms = new_group_commit_ms > 0 ? new_group_commit_ms : 1;
+}
+
+int Journal::open(const std::string& journal_path, TaskManager& task_manager, PersonManager& person_manager,
+                  std::uint64_t after_lsn) {
+    close();
+    last_lsn = after_lsn;
+    replayed = 0;
+
+    // Records moved aside by a checkpoint that never finished come first.
+    std::string old_path = journal_path + ".old";
+    int old_file = ::open(old_path.c_str(), O_RDONLY);
+    if (old_file >= 0) {
+        std::vector<char> contents;
+        struct stat st;
+        bool ok = ::fstat(old_file, &st) == 0 && read_all(old_file, contents, static_cast<size_t>(st.st_size));
+        ::close(old_file);
+        const char* error = ok ? check_header(contents) : "cannot be read";
+        if (error) {
+            std::cerr << "Error: Journal '" << old_path << "' " << error << "." << std::endl;
+            return 0;
+        }
+        replay_records(contents, old_path, task_manager, person_manager);
+    }
+
+    int file = ::open(journal_path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (file < 0) {
+        std::cerr << "Error: Cannot open journal '" << journal_path << "': " << std::strerror(errno) << std::endl;
+        return 0;
+    }
+    auto fail = [&](const char* reason) {
+        std::cerr << "Error: Journal '" << journal_path << "' " << reason << "." << std::endl;
+        ::close(file);
+        return 0;
+    };
+
+    struct stat st;
+    if (::fstat(file, &st) != 0) return fail("cannot be read");
+    std::uint64_t file_size = static_cast<std::uint64_t>(st.st_size);
+    std::uint64_t valid_size = sizeof(JournalHeader);
+
+    if (file_size < sizeof(JournalHeader)) {
+        // New (or never completed) journal: start it with a header.
+        if (!write_header(file)) return fail("cannot be initialized");
+    } else {
+        std::vector<char> contents;
+        if (!read_all(file, contents, file_size)) return fail("cannot be read");
+        if (const char* error = check_header(contents)) return fail(error);
+        valid_size = replay_records(contents, journal_path, task_manager, person_manager);
+        if (valid_size < file_size) {
+            std::cerr << "Warning: Dropping " << (file_size - valid_size) << " bytes of incomplete records at the end of journal '"
+                      << journal_path << "'." << std::endl;
+            if (::ftruncate(file, static_cast<off_t>(valid_size)) != 0 || ::fsync(file) != 0) {
+                return fail("cannot be repaired");
+            }
+        }
+    }
+
+    fd = file;
+    path = journal_path;
+    size = valid_size;
+    if (policy == FsyncPolicy::Group) {
+        stopping = false;
+        dirty = false;
+        flusher = std::thread(&Journal::flush_loop, this);
+    }
+    return 1;
+}
+
+// Applies the records newer than last_lsn, up to the first one that is cut
+// short, fails its checksum or goes back in LSN order: everything after it is
+// a tail the last run never finished writing. Returns the size of the intact
+// prefix.
+std::uint64_t Journal::replay_records(const std::vector<char>& contents, const std::string& label,
+                                      TaskManager& task_manager, PersonManager& person_manager) {
+    const std::uint64_t file_size = contents.size();
+    std::uint64_t valid_size = sizeof(JournalHeader);
+    std::uint64_t previous_lsn = 0;
+    while (file_size - valid_size >= sizeof(JournalRecordHeader)) {
+        const char* at = contents.data() + valid_size;
+        JournalRecordHeader record_header;
+        std::memcpy(&record_header, at, sizeof(record_header));
+        std::uint64_t record_size = sizeof(JournalRecordHeader) + record_header.payload_size;
+        if (record_header.payload_size == 0 || record_size > file_size - valid_size) break;
+        if (record_checksum(at + 8, record_size - 8) != record_header.checksum) break;
+        if (record_header.lsn <= previous_lsn) break;
+
+        const char* payload = at + sizeof(JournalRecordHeader);
+        if (record_header.lsn > last_lsn) {
+            if (record_header.lsn != last_lsn + 1) {
+                std::cerr << "Warning: Journal '" << label << "' jumps from LSN " << last_lsn << " to "
+                          << record_header.lsn << "; some changes are missing." << std::endl;
+            }
+            auto op = static_cast<JournalOp>(payload[0]);
+            if (!apply_record(op, FieldReader(payload + 1, record_header.payload_size - 1),
+                              task_manager, person_manager)) {
+                std::cerr << "Warning: Skipping undecodable journal record " << record_header.lsn << "." << std::endl;
+            }
+            last_lsn = record_header.lsn;
+            ++replayed;
+        }
+        previous_lsn = record_header.lsn;
+        valid_size += record_size;
+    }
+    return valid_size;
+}
+
+void Journal::close() {
+    if (fd < 0) return;
+    if (flusher.joinable()) {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        flusher.join();
+    }
+    if (policy != FsyncPolicy::PerCommand) {
+        ::fdatasync(fd);
+    }
+    ::close(fd);
+    fd = -1;
+}
+
+void Journal::put_field(int value) {
+    auto raw = static_cast<std::uint32_t>(value);
+    const char* bytes = reinterpret_cast<const char*>(&raw);
+    record.insert(record.end(), bytes, bytes + sizeof(raw));
+}
+
+void Journal::put_field(std::string_view value) {
+    put_field(static_cast<int>(value.size()));
+    record.insert(record.end(), value.begin(), value.end());
+}
+
+std::uint64_t Journal::commit_record() {
+    JournalRecordHeader header;
+    header.payload_size = static_cast<std::uint32_t>(record.size() - sizeof(JournalRecordHeader));
+    header.lsn = last_lsn + 1;
+    std::memcpy(record.data() + 8, &header.lsn, sizeof(header.lsn));
+    header.checksum = record_checksum(record.data() + 8, record.size() - 8);
+    std::memcpy(record.data(), &header, 8);
+
+    std::unique_lock lock(mutex);
+    if (!write_all(fd, record.data(), record.size())) {
+        std::cerr << "Error: Failed to append to journal '" << path << "': " << std::strerror(errno) << std::endl;
+        // Cut off whatever part of the record made it, so later appends stay readable.
+        if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            std::cerr << "Error: Journal '" << path << "' may end in a partial record." << std::endl;
+        }
+        return 0;
+    }
+    size += record.size();
+    last_lsn = header.lsn;
+    if (policy == FsyncPolicy::PerCommand) {
+        lock.unlock();
+        if (::fdatasync(fd) != 0) {
+            std::cerr << "Error: Failed to sync journal '" << path << "': " << std::strerror(errno) << std::endl;
+            return 0;
+        }
+    } else {
+        dirty = true;
+    }
+    return last_lsn;
+}
+
+int Journal::truncate() {
+    if (fd < 0) return 0;
+    std::lock_guard lock(mutex);
+    if (::ftruncate(fd, sizeof(JournalHeader)) != 0 || ::fsync(fd) != 0) {
+        std::cerr << "Error: Failed to truncate journal '" << path << "': " << std::strerror(errno) << std::endl;
+        return 0;
+    }
+    size = sizeof(JournalHeader);
+    dirty = false;
+    return 1;
+}
+
+int Journal::rotate() {
+    if (fd < 0) return 0;
+    std::string old_path = path + ".old";
+    if (::access(old_path.c_str(), F_OK) == 0) {
+        return 0;  // Still held by a checkpoint that has not completed
+    }
+    // The flusher may be syncing the current descriptor outside the lock;
+    // it must be done before that descriptor is closed below, or the sync
+    // could land on a closed or reused one.
+    std::unique_lock lock(mutex);
+    synced.wait(lock, [this] { return !syncing; });
+    if (::fdatasync(fd) != 0 || ::rename(path.c_str(), old_path.c_str()) != 0) {
+        std::cerr << "Error: Failed to rotate journal '" << path << "': " << std::strerror(errno) << std::endl;
+        return 0;
+    }
+    int file = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_APPEND, 0644);
+    if (file < 0 || !write_header(file)) {
+        std::cerr << "Error: Failed to start a new journal '" << path << "': " << std::strerror(errno) << std::endl;
+        if (file >= 0) ::close(file);
+        ::rename(old_path.c_str(), path.c_str());  // Keep appending to the old one
+        return 0;
+    }
+    ::close(fd);
+    fd = file;
+    size = sizeof(JournalHeader);
+    dirty = false;
+    return 1;
+}
+
+void Journal::drop_rotated() {
+    if (path.empty()) return;
+    ::unlink((path + ".old").c_str());
+}
+
+int Journal::sync() {
+    if (fd < 0) return 0;
+    {
+        std::lock_guard lock(mutex);
+        dirty = false;
+    }
+    return ::fdatasync(fd) == 0 ? 1 : 0;
+}
+
+void Journal::flush_loop() {
+    std::unique_lock lock(mutex);
+    while (!stopping) {
+        wake.wait_for(lock, std::chrono::milliseconds(group_commit_ms));
+        if (!dirty) continue;
+        dirty = false;
+        int file = fd;
+        // Sync outside the lock so appends are not held up by the disk;
+        // rotate() waits for it before closing file.
+        syncing = true;
+        lock.unlock();
+        ::fdatasync(file);
+        lock.lock();
+        syncing = false;
+        synced.notify_all();
+    }
+}
@@ -0,0 +1,332 @@
+#include "json_stream.hpp"
+
+#include <charconv>
+#include <cstring>
+#include <istream>
+#include <ostream>
+
+// --- JsonWriter ---
+
+JsonWriter::JsonWriter(std::ostream& out, std::size_t buffer_size) : out(out), buffer_size(buffer_size) {
+    buffer.reserve(buffer_size + 256);
+}
+
+JsonWriter::~JsonWriter() {
+    flush();
+}
+
+void JsonWriter::flush() {
+    if (buffer.empty()) return;
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    written += buffer.size();
+    buffer.clear();
+}
+
+// Emits the comma separating this value from the previous one in the same
+// container. Array elements go on their own line so exports stay greppable.
+void JsonWriter::before_value() {
+    if (after_key) {
+        after_key = false;
+        return;
+    }
+    if (scopes.empty()) return;
+    Scope& scope = scopes.back();
+    if (scope.has_items) put(',');
+    if (scope.is_array) put('\n');
+    scope.has_items = true;
+    maybe_flush();
+}
+
+void JsonWriter::begin_object() {
+    before_value();
+    put('{');
+    scopes.push_back({false, false});
+}
+
+void JsonWriter::end_object() {
+    scopes.pop_back();
+    put('}');
+}
+
+void JsonWriter::begin_array() {
+    before_value();
+    put('[');
+    scopes.push_back({true, false});
+}
+
+void JsonWriter::end_array() {
+    if (scopes.back().has_items) put('\n');
+    scopes.pop_back();
+    put(']');
+}
+
+void JsonWriter::key(std::string_view name) {
+    value(name);
+    put(':');
+    after_key = true;
+}
+
+void JsonWriter::value(std::string_view text) {
+    before_value();
+    put('"');
+    size_t clean = 0;  // Start of the run of characters that need no escaping
+    for (size_t i = 0; i < text.size(); ++i) {
+        auto c = static_cast<unsigned char>(text[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+        put(text.substr(clean, i - clean));
+        clean = i + 1;
+        switch (c) {
+        case '"': put("\\\""); break;
+        case '\\': put("\\\\"); break;
+        case '\n': put("\\n"); break;
+        case '\r': put("\\r"); break;
+        case '\t': put("\\t"); break;
+        case '\b': put("\\b"); break;
+        case '\f': put("\\f"); break;
+        default: {
+            static const char hex[] = "0123456789abcdef";
+            char escaped[] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+            put(std::string_view(escaped, sizeof(escaped)));
+        }
+        }
+    }
+    put(text.substr(clean));
+    put('"');
+}
+
+void JsonWriter::value(std::int64_t number) {
+    before_value();
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), number);
+    put(std::string_view(digits, static_cast<size_t>(result.ptr - digits)));
+}
+
+void JsonWriter::null() {
+    before_value();
+    put("null");
+}
+
+// --- JsonParser ---
+
+JsonParser::JsonParser(std::istream& in, std::size_t buffer_size) : in(in), buffer(buffer_size) {}
+
+int JsonParser::next_char() {
+    if (position == length) {
+        consumed += length;
+        position = 0;
+        length = 0;
+        if (!in) return -1;
+        in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        length = static_cast<size_t>(in.gcount());
+        if (length == 0) return -1;
+    }
+    return static_cast<unsigned char>(buffer[position++]);
+}
+
+int JsonParser::next_non_space() {
+    int c;
+    do {
+        c = next_char();
+    } while (c == ' ' || c == '\n' || c == '\r' || c == '\t');
+    return c;
+}
+
+int JsonParser::fail(const char* message) {
+    error_message = std::string(message) + " at byte " + std::to_string(bytes_read());
+    return 0;
+}
+
+// Called after the opening quote. A string that ends inside the current
+// block without escapes is returned as a view into the block; anything else
+// is assembled in scratch.
+bool JsonParser::read_string(std::string_view& text) {
+    const char* start = buffer.data() + position;
+    const char* end = buffer.data() + length;
+    for (const char* p = start; p < end; ++p) {
+        if (*p == '"') {
+            text = std::string_view(start, static_cast<size_t>(p - start));
+            position += text.size() + 1;
+            return true;
+        }
+        if (*p == '\\' || static_cast<unsigned char>(*p) < 0x20) break;
+    }
+
+    scratch.clear();
+    while (true) {
+        int c = next_char();
+        if (c < 0) return fail("unterminated string");
+        if (c == '"') break;
+        if (c < 0x20) return fail("control character in string");
+        if (c != '\\') {
+            scratch.push_back(static_cast<char>(c));
+            continue;
+        }
+        c = next_char();
+        switch (c) {
+        case '"': scratch.push_back('"'); break;
+        case '\\': scratch.push_back('\\'); break;
+        case '/': scratch.push_back('/'); break;
+        case 'b': scratch.push_back('\b'); break;
+        case 'f': scratch.push_back('\f'); break;
+        case 'n': scratch.push_back('\n'); break;
+        case 'r': scratch.push_back('\r'); break;
+        case 't': scratch.push_back('\t'); break;
+        case 'u': {
+            std::uint32_t code = 0;
+            for (int i = 0; i < 4; ++i) {
+                int h = next_char();
+                int digit = (h >= '0' && h <= '9') ? h - '0'
+                          : (h >= 'a' && h <= 'f') ? h - 'a' + 10
+                          : (h >= 'A' && h <= 'F') ? h - 'A' + 10 : -1;
+                if (digit < 0) return fail("bad \\u escape");
+                code = code * 16 + static_cast<std::uint32_t>(digit);
+            }
+            // Encode as UTF-8. Surrogate pairs are passed through as two
+            // three-byte sequences; the exporter never produces them.
+            if (code < 0x80) {
+                scratch.push_back(static_cast<char>(code));
+            } else if (code < 0x800) {
+                scratch.push_back(static_cast<char>(0xC0 | (code >> 6)));
+                scratch.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+            } else {
+                scratch.push_back(static_cast<char>(0xE0 | (code >> 12)));
+                scratch.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+                scratch.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+            }
+            break;
+        }
+        default:
+            return fail("bad escape in string");
+        }
+    }
+    text = scratch;
+    return true;
+}
+
+bool JsonParser::read_number(int first, std::string_view& text) {
+    scratch.assign(1, static_cast<char>(first));
+    while (true) {
+        if (position == length) {
+            // Refill without losing the characters collected so far.
+            int c = next_char();
+            if (c < 0) break;
+            --position;
+        }
+        char c = buffer[position];
+        if ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E') {
+            scratch.push_back(c);
+            ++position;
+        } else {
+            break;
+        }
+    }
+    text = scratch;
+    return true;
+}
+
+bool JsonParser::expect_literal(const char* rest) {
+    for (; *rest; ++rest) {
+        if (next_char() != *rest) return fail("invalid literal");
+    }
+    return true;
+}
+
+int JsonParser::parse(JsonHandler& handler) {
+    enum class Expect { Value, ValueOrEnd, Key, KeyOrEnd, Colon, CommaOrEnd };
+    Expect expect = Expect::Value;
+    std::vector<char> stack;  // '{' or '[' per open container
+    error_message.clear();
+
+    while (true) {
+        int c = next_non_space();
+        if (c < 0) {
+            if (stack.empty() && expect == Expect::CommaOrEnd) return 1;
+            return fail("unexpected end of input");
+        }
+        bool ok = true;
+        switch (expect) {
+        case Expect::Colon:
+            if (c != ':') return fail("expected ':'");
+            expect = Expect::Value;
+            continue;
+        case Expect::CommaOrEnd:
+            if (stack.empty()) return fail("trailing characters");
+            if (c == ',') {
+                expect = stack.back() == '{' ? Expect::Key : Expect::Value;
+            } else if (c == '}' && stack.back() == '{') {
+                stack.pop_back();
+                ok = handler.on_end_object();
+            } else if (c == ']' && stack.back() == '[') {
+                stack.pop_back();
+                ok = handler.on_end_array();
+            } else {
+                return fail("expected ',' or a closing bracket");
+            }
+            break;
+        case Expect::Key:
+        case Expect::KeyOrEnd:
+            if (c == '}' && expect == Expect::KeyOrEnd) {
+                stack.pop_back();
+                ok = handler.on_end_object();
+                expect = Expect::CommaOrEnd;
+            } else if (c == '"') {
+                std::string_view key;
+                if (!read_string(key)) return 0;
+                ok = handler.on_key(key);
+                expect = Expect::Colon;
+            } else {
+                return fail("expected a key");
+            }
+            break;
+        case Expect::Value:
+        case Expect::ValueOrEnd:
+            if (c == ']' && expect == Expect::ValueOrEnd) {
+                stack.pop_back();
+                ok = handler.on_end_array();
+                expect = Expect::CommaOrEnd;
+                break;
+            }
+            expect = Expect::CommaOrEnd;
+            switch (c) {
+            case '{':
+                stack.push_back('{');
+                ok = handler.on_begin_object();
+                expect = Expect::KeyOrEnd;
+                break;
+            case '[':
+                stack.push_back('[');
+                ok = handler.on_begin_array();
+                expect = Expect::ValueOrEnd;
+                break;
+            case '"': {
+                std::string_view text;
+                if (!read_string(text)) return 0;
+                ok = handler.on_string(text);
+                break;
+            }
+            case 't':
+                if (!expect_literal("rue")) return 0;
+                ok = handler.on_bool(true);
+                break;
+            case 'f':
+                if (!expect_literal("alse")) return 0;
+                ok = handler.on_bool(false);
+                break;
+            case 'n':
+                if (!expect_literal("ull")) return 0;
+                ok = handler.on_null();
+                break;
+            default:
+                if (c == '-' || (c >= '0' && c <= '9')) {
+                    std::string_view text;
+                    read_number(c, text);
+                    ok = handler.on_number(text);
+                } else {
+                    return fail("expected a value");
+                }
+            }
+            break;
+        }
+        if (!ok) return 0;
+    }
+}
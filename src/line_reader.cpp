@@ -0,0 +1,56 @@
+#include "line_reader.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+#include <unistd.h>
+
+LineReader::LineReader(int fd, std::size_t block_size) : fd(fd), block_size(block_size), buffer(block_size) {}
+
+bool LineReader::next(std::string_view& line) {
+    while (true) {
+        const char* start = buffer.data() + begin;
+        const void* newline = std::memchr(start, '\n', end - begin);
+        if (newline) {
+            std::size_t length = static_cast<const char*>(newline) - start;
+            begin += length + 1;
+            if (length > 0 && start[length - 1] == '\r') --length;
+            line = std::string_view(start, length);
+            return true;
+        }
+        if (eof) {
+            if (begin == end) return false;
+            // Last line without a terminator
+            std::size_t length = end - begin;
+            if (start[length - 1] == '\r') --length;
+            line = std::string_view(start, length);
+            begin = end;
+            return true;
+        }
+        fill();
+    }
+}
+
+// Moves the partial line to the front of the buffer (growing it if a single
+// line is longer than the buffer) and reads the next block behind it.
+bool LineReader::fill() {
+    if (begin > 0) {
+        std::memmove(buffer.data(), buffer.data() + begin, end - begin);
+        end -= begin;
+        begin = 0;
+    }
+    if (buffer.size() - end < block_size / 2) {
+        buffer.resize(buffer.size() + block_size);
+    }
+    while (true) {
+        ssize_t got = ::read(fd, buffer.data() + end, buffer.size() - end);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) {
+            error = got < 0;
+            eof = true;
+            return false;
+        }
+        end += static_cast<std::size_t>(got);
+        return true;
+    }
+}
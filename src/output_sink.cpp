@@ -0,0 +1,63 @@
+#include "output_sink.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+// Indentation for the first indent_levels levels is a prefix of this string;
+// deeper levels are written in chunks of it.
+constexpr int indent_levels = 64;
+constexpr char dashes[] =
+    "----------------------------------------------------------------"
+    "----------------------------------------------------------------";
+static_assert(sizeof(dashes) - 1 == 2 * indent_levels);
+
+} // namespace
+
+OutputSink::OutputSink(std::ostream& out, std::size_t capacity)
+    : out(out), capacity(std::max(capacity, max_number_size)), buffer(new char[this->capacity]) {}
+
+OutputSink::~OutputSink() {
+    flush();
+}
+
+void OutputSink::flush() {
+    if (used == 0) return;
+    out.write(buffer.get(), static_cast<std::streamsize>(used));
+    used = 0;
+}
+
+OutputSink& OutputSink::operator<<(std::string_view text) {
+    if (text.size() > capacity - used) {
+        flush();
+        if (text.size() >= capacity) {
+            // Too big to be worth copying; it goes straight to the stream.
+            out.write(text.data(), static_cast<std::streamsize>(text.size()));
+            return *this;
+        }
+    }
+    std::memcpy(buffer.get() + used, text.data(), text.size());
+    used += text.size();
+    return *this;
+}
+
+OutputSink& OutputSink::operator<<(double value) {
+    if (capacity - used < max_number_size) flush();
+    char* end = std::to_chars(buffer.get() + used, buffer.get() + capacity, value,
+                              std::chars_format::general, 6).ptr;
+    used = static_cast<std::size_t>(end - buffer.get());
+    return *this;
+}
+
+void OutputSink::indent(int level) {
+    for (int remaining = level - 1; remaining > 0; remaining -= indent_levels) {
+        *this << std::string_view(dashes, 2 * static_cast<std::size_t>(std::min(remaining, indent_levels)));
+    }
+}
+
+OutputSink& get_output() {
+    static OutputSink output(std::cout);
+    return output;
+}
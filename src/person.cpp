@@ -1,37 +1,58 @@
 #include "person.hpp"
+#include "output_sink.hpp"
+#include "id_bitmap.hpp"
 #include "task.hpp"
 
-#include <algorithm>
 #include <iostream>
 
-Person::Person(const std::string& name) : name(name) {}
+Person::Person(const std::string& name, int id) : id(id), name(name) {}
 
 Person::~Person() {
-    remove_all_tasks();
+    remove_all_tasks();  // Leaves the tasks alive but ownerless
+}
+
+int Person::get_id() const {
+    return id;
 }
 
 const std::string Person::get_name() const {
     return name;
 }
 
+std::string_view Person::get_name_view() const {
+    return name;
+}
+
 void Person::set_name(const std::string& new_name) {
     name = new_name;
 }
 
 void Person::remove_all_tasks() {
-    for (Task* task : tasks) {
-        delete task;
+    // Unassigning the last task is a plain pop, so this is O(k).
+    while (!tasks.empty()) {
+        tasks.back()->set_owner(nullptr);
     }
-    tasks.clear();
 }
 
 void Person::remove_task(Task* task) {
-    auto it = std::find(tasks.begin(), tasks.end(), task);
-    if (it != tasks.end()) {
-        tasks.erase(it);
+    if (task && task->get_owner() == this) {
+        task->set_owner(nullptr);
     }
 }
 
+void Person::link_task(Task* task) {
+    task->owner_slot = static_cast<std::int32_t>(tasks.size());
+    tasks.push_back(task);
+}
+
+void Person::unlink_task(Task* task) {
+    Task* last = tasks.back();
+    tasks[task->owner_slot] = last;
+    last->owner_slot = task->owner_slot;
+    tasks.pop_back();
+    task->owner_slot = -1;
+}
+
 void Person::set_all_tasks_to_done() {
     for (Task* task : tasks) {
         task->mark_as_done();
@@ -48,21 +69,36 @@ int Person::return_number_of_tasks(const PrintOptions& options) const {
     return count;
 }
 
+int Person::return_number_of_tasks(const IdBitmap& owned, const IdBitmap& children,
+                                   const PrintOptions& options) const {
+    if (options.nested) {
+        return static_cast<int>(owned.count());
+    }
+    return static_cast<int>(IdBitmap::and_not_count(owned, children));
+}
+
 void Person::assign_task(Task* task) {
-    tasks.push_back(task);
+    if (task) {
+        task->set_owner(this);
+    }
 }
 
 std::vector<Task*> Person::get_tasks() const {
     return tasks;
 }
 
+std::span<Task* const> Person::get_tasks_view() const {
+    return tasks;
+}
+
 void Person::print_all_tasks(const PrintOptions& options) const {
+    OutputSink& out = get_output();
     for (const Task* task : tasks) {
         if (options.verbose) {
-            std::cout << "Task ID: " << task->get_id() << ", Name: " << task->get_name() << std::endl;
+            out << "Task ID: " << task->get_id() << ", Name: " << task->get_name_view() << "\n";
         }
         if (options.nested || !task->get_parent()) {
-            std::cout << " - " << task->get_name() << std::endl;
+            out << " - " << task->get_name_view() << "\n";
         }
     }
 }
\ No newline at end of file
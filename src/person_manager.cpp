@@ -1,9 +1,11 @@
 #include "person_manager.hpp"
+#include "id_bitmap.hpp"
+#include "output_sink.hpp"
 #include "person.hpp"
+#include "record_writer.hpp"
 #include "task.hpp"
 
 #include <iostream>
-#include <algorithm>
 
 // PersonManager class implementation
 PersonManager::PersonManager() = default;  
@@ -11,56 +13,66 @@ PersonManager::~PersonManager() {
     delete_all_people();
 }
 
-const Person* PersonManager::find_person_by_name(const std::string& name) const {
-    for (const auto& person : people) {
-        if (person->get_name() == name) {
-            return person.get();              // return raw pointer, no copy
-        }
-    }
-    return nullptr;
+const Person* PersonManager::find_person_by_name(std::string_view name) const {
+    auto it = people_by_name.find(name);
+    return it != people_by_name.end() ? it->second : nullptr;
 }
 
-Person* PersonManager::find_person_by_name(const std::string& name) {
-    for (auto& person : people) {
-        if (person->get_name() == name) return person.get();
-    }
-    return nullptr;
+Person* PersonManager::find_person_by_name(std::string_view name) {
+    auto it = people_by_name.find(name);
+    return it != people_by_name.end() ? it->second : nullptr;
 }
 
 // CRUD operations
 
 // Change a person's name
-int PersonManager::change_name(const std::string& old_name, const std::string& new_name) {
-    for (const auto& person : people) {
-        if (person->get_name() == old_name) {
-            person->set_name(new_name);
-            return 1;  // Success
-        }
+int PersonManager::change_name(std::string_view old_name, std::string_view new_name) {
+    auto it = people_by_name.find(old_name);
+    if (it == people_by_name.end()) {
+        return 0;  // Person not found
     }
-    return 0;  // Person not found
+    if (old_name == new_name) {
+        return 1;  // Nothing to do
+    }
+    if (people_by_name.find(new_name) != people_by_name.end()) {
+        std::cerr << "Error: Person '" << new_name << "' already exists." << std::endl;
+        return 0;
+    }
+    // Re-key the existing node in place instead of erasing and re-inserting it.
+    auto node = people_by_name.extract(it);
+    node.key() = new_name;
+    node.mapped()->set_name(node.key());
+    people_by_name.insert(std::move(node));
+    return 1;  // Success
 }
 
 // Delete all people
 void PersonManager::delete_all_people() {
-    for (auto& person : people) {
-        person.reset();  // Automatically calls Person's destructor
-    }
+    people_by_name.clear();
     people.clear();
+    person_pool.clear();  // Runs every Person's destructor, then frees the chunks
 }
 
 // Add a new person
-int PersonManager::add_person(const std::string& name) {
+int PersonManager::add_person(std::string_view name) {
     // If person of the same name exists, print an error and return 0
-    if (find_person_by_name(name)) {
+    auto [it, inserted] = people_by_name.try_emplace(std::string(name), nullptr);
+    if (!inserted) {
         std::cerr << "Error: Person '" << name << "' already exists." << std::endl;
         return 0;
     }
-    people.emplace_back(std::make_unique<Person>(name));
+    int new_id = next_id++;
+    if (people.size() <= static_cast<size_t>(new_id)) {
+        people.resize(new_id + 1);  // Slot 0 is never used
+    }
+    people[new_id] = person_pool.create(it->first, new_id);
+    it->second = people[new_id];
     return 1;  // Success
 }
 
-// Delete a person's all tasks
-int PersonManager::delete_persons_all_tasks(const std::string& name) {
+// Unassigns all of a person's tasks without deleting them; they belong to
+// TaskManager, whose delete_tasks_owned_by deletes them.
+int PersonManager::unassign_persons_all_tasks(std::string_view name) {
     auto person = find_person_by_name(name);
     if (person) {
         person->remove_all_tasks();
@@ -70,7 +82,7 @@ int PersonManager::delete_persons_all_tasks(const std::string& name) {
 }
 
 // Set a person's all tasks as done
-int PersonManager::set_persons_all_tasks_as_done(const std::string& name) {
+int PersonManager::set_persons_all_tasks_as_done(std::string_view name) {
     auto person = find_person_by_name(name);
     if (person) {
         person->set_all_tasks_to_done();
@@ -80,7 +92,7 @@ int PersonManager::set_persons_all_tasks_as_done(const std::string& name) {
 }
 
 // Assign a task to a person
-int PersonManager::assign_task(const std::string& name, Task* task) {
+int PersonManager::assign_task(std::string_view name, Task* task) {
     auto person = find_person_by_name(name);
     if (person) {
         person->assign_task(task);
@@ -95,8 +107,16 @@ int PersonManager::assign_task(const std::string& name, Task* task) {
 
 // Print all people
 void PersonManager::print_all_people(const PrintOptions& options) const {
-    for (const auto& person : people) {
-        std::cout << person->get_name() << std::endl;
+    if (options.format != OutputFormat::Text) {
+        RecordWriter writer(get_output(), options.format, person_columns);
+        for (const Person* person : people) {
+            if (person) write_person_record(writer, *person);
+        }
+        return;
+    }
+    for (const Person* person : people) {
+        if (!person) continue;  // Empty slot left by a deleted person
+        get_output() << person->get_name_view() << "\n";
         if (options.verbose) {
             person->print_all_tasks(options);
         }
@@ -104,10 +124,15 @@ void PersonManager::print_all_people(const PrintOptions& options) const {
 }
 
 // Print a specific person
-void PersonManager::print_person(const std::string& name, const PrintOptions& options) const {
+void PersonManager::print_person(std::string_view name, const PrintOptions& options) const {
     auto person = find_person_by_name(name);
+    if (person && options.format != OutputFormat::Text) {
+        RecordWriter writer(get_output(), options.format, person_columns);
+        write_person_record(writer, *person);
+        return;
+    }
     if (person) {
-        std::cout << person->get_name() << std::endl;
+        get_output() << person->get_name_view() << "\n";
         if (options.verbose) {
             person->print_all_tasks(options);
         }
@@ -117,11 +142,35 @@ void PersonManager::print_person(const std::string& name, const PrintOptions& op
 }
 
 // Print a person's tasks
-void PersonManager::print_persons_tasks(const std::string& name, const PrintOptions& options) const {
+void PersonManager::print_persons_tasks(std::string_view name, const PrintOptions& options) const {
     auto person = find_person_by_name(name);
+    if (person && options.format != OutputFormat::Text) {
+        RecordWriter writer(get_output(), options.format, task_columns);
+        for (const Task* task : person->get_tasks_view()) {
+            write_task_record(writer, *task);
+        }
+        return;
+    }
+    if (person && options.nested) {
+        // Each task under its parent when the person owns that too: the walks
+        // start at the tasks whose parent is someone else's (or none) and
+        // stop at tasks that are not the person's, so each prints once.
+        OutputSink& out = get_output();
+        for (const Task* root : person->get_tasks_view()) {
+            const Task* parent = root->get_parent();
+            if (parent && parent->get_owner() == person) continue;
+            walk_task_tree(root, [&](const Task* task, int depth) {
+                if (task->get_owner() != person) return false;
+                out.indent(depth + 1);
+                out << " - " << task->get_id() << ": " << task->get_name_view() << "\n";
+                return true;
+            });
+        }
+        return;
+    }
     if (person) {
-        for(const auto& task : person->get_tasks()) {
-            std::cout << " - " << task->get_id() << ": " << task->get_name() << std::endl; // Extend later with nested printing
+        for (const Task* task : person->get_tasks_view()) {
+            get_output() << " - " << task->get_id() << ": " << task->get_name_view() << "\n";
         }
         return;
     }
@@ -129,23 +178,30 @@ void PersonManager::print_persons_tasks(const std::string& name, const PrintOpti
 }
 
 // Print all people's task counts
-void PersonManager::print_all_peoples_task_counts(bool nested) const {
+void PersonManager::print_all_peoples_task_counts(bool nested, std::span<const IdBitmap> owner_sets,
+                                                  const IdBitmap& child_set) const {
+    static const IdBitmap none;  // People who never owned a task have no set
     PrintOptions options;
     options.nested = nested;
-    for (const auto& person : people) {
-        std::cout << person->get_name() << ": " << person->return_number_of_tasks(options) << std::endl;
+    for (const Person* person : people) {
+        if (!person) continue;
+        size_t id = static_cast<size_t>(person->get_id());
+        const IdBitmap& owned = id < owner_sets.size() ? owner_sets[id] : none;
+        get_output() << person->get_name_view() << ": " << person->return_number_of_tasks(owned, child_set, options)
+                     << "\n";
     }
 }
 
 // Delete a person by name
-int PersonManager::delete_person(const std::string& name) {
-    auto it = std::remove_if(people.begin(), people.end(),
-        [&name](const std::unique_ptr<Person>& person) {
-            return person->get_name() == name;
-        });
-    if (it != people.end()) {
-        people.erase(it, people.end());
-        return 1;  // Success
+int PersonManager::delete_person(std::string_view name) {
+    auto it = people_by_name.find(name);
+    if (it == people_by_name.end()) {
+        return 0;  // Person not found
     }
-    return 0;  // Person not found
+    Person* person = it->second;
+    people_by_name.erase(it);
+    person->remove_all_tasks();  // O(k) in the person's tasks, leaves them unowned
+    people[person->get_id()] = nullptr;
+    person_pool.destroy(person);
+    return 1;  // Success
 }
\ No newline at end of file
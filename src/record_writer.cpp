@@ -0,0 +1,140 @@
+#include "record_writer.hpp"
+#include "output_sink.hpp"
+#include "person.hpp"
+#include "task.hpp"
+
+bool parse_output_format(std::string_view name, OutputFormat& format) {
+    if (name == "text") {
+        format = OutputFormat::Text;
+    } else if (name == "jsonl") {
+        format = OutputFormat::Jsonl;
+    } else if (name == "csv") {
+        format = OutputFormat::Csv;
+    } else if (name == "tsv") {
+        format = OutputFormat::Tsv;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+RecordWriter::RecordWriter(OutputSink& out, OutputFormat format, std::span<const std::string_view> columns)
+    : out(out), format(format), columns(columns) {
+    if (format != OutputFormat::Csv && format != OutputFormat::Tsv) return;
+    for (std::string_view name : columns) {
+        field(name);
+    }
+    end_record();
+}
+
+void RecordWriter::begin_field() {
+    if (format == OutputFormat::Jsonl) {
+        out << (column == 0 ? '{' : ',') << '"' << columns[column] << "\":";
+    } else if (column > 0) {
+        out << (format == OutputFormat::Csv ? ',' : '\t');
+    }
+    ++column;
+}
+
+void RecordWriter::field(std::string_view text) {
+    begin_field();
+    write_escaped(text);
+}
+
+void RecordWriter::field(std::int64_t number) {
+    begin_field();
+    out << number;
+}
+
+void RecordWriter::null_field() {
+    begin_field();
+    if (format == OutputFormat::Jsonl) out << "null";
+}
+
+void RecordWriter::end_record() {
+    if (format == OutputFormat::Jsonl) out << '}';
+    out << '\n';
+    column = 0;
+}
+
+// Copies the runs between characters that need escaping straight into the
+// sink, so a clean field costs one scan and one copy.
+void RecordWriter::write_escaped(std::string_view text) {
+    std::size_t clean = 0;  // Start of the pending run of plain characters
+    switch (format) {
+    case OutputFormat::Jsonl:
+        out << '"';
+        for (std::size_t i = 0; i < text.size(); ++i) {
+            auto c = static_cast<unsigned char>(text[i]);
+            if (c >= 0x20 && c != '"' && c != '\\') continue;
+            out << text.substr(clean, i - clean);
+            clean = i + 1;
+            switch (c) {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\r': out << "\\r"; break;
+            case '\t': out << "\\t"; break;
+            default: {
+                static const char hex[] = "0123456789abcdef";
+                char escaped[] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+                out << std::string_view(escaped, sizeof(escaped));
+            }
+            }
+        }
+        out << text.substr(clean) << '"';
+        break;
+    case OutputFormat::Csv:
+        if (text.find_first_of(",\"\r\n") == std::string_view::npos) {
+            out << text;
+            break;
+        }
+        out << '"';
+        for (std::size_t quote = text.find('"'); quote != std::string_view::npos;
+             quote = text.find('"', quote + 1)) {
+            out << text.substr(clean, quote + 1 - clean) << '"';  // "" for each "
+            clean = quote + 1;
+        }
+        out << text.substr(clean) << '"';
+        break;
+    case OutputFormat::Tsv:
+        for (std::size_t i = 0; i < text.size(); ++i) {
+            char c = text[i];
+            if (c != '\t' && c != '\n' && c != '\r' && c != '\\') continue;
+            out << text.substr(clean, i - clean) << '\\'
+                << (c == '\t' ? 't' : c == '\n' ? 'n' : c == '\r' ? 'r' : '\\');
+            clean = i + 1;
+        }
+        out << text.substr(clean);
+        break;
+    case OutputFormat::Text:
+        out << text;
+        break;
+    }
+}
+
+void write_task_record(RecordWriter& writer, const Task& task) {
+    writer.field(std::int64_t{task.get_id()});
+    writer.field(task.get_name_view());
+    writer.field(task.get_description_view());
+    writer.field(Task::status_name(task.get_status()));
+    if (const Person* owner = task.get_owner()) {
+        writer.field(owner->get_name_view());
+    } else {
+        writer.null_field();
+    }
+    if (const Task* parent = task.get_parent()) {
+        writer.field(std::int64_t{parent->get_id()});
+    } else {
+        writer.null_field();
+    }
+    writer.field(std::int64_t{task.get_level()});
+    writer.end_record();
+}
+
+void write_person_record(RecordWriter& writer, const Person& person) {
+    writer.field(std::int64_t{person.get_id()});
+    writer.field(person.get_name_view());
+    writer.field(static_cast<std::int64_t>(person.get_tasks_view().size()));
+    writer.end_record();
+}
@@ -0,0 +1,305 @@
+#include "snapshot.hpp"
+#include "person.hpp"
+#include "person_manager.hpp"
+#include "task.hpp"
+#include "task_manager.hpp"
+
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static_assert(std::endian::native == std::endian::little, "snapshots are little-endian");
+
+namespace {
+
+// Read-only private mapping of a whole file, unmapped on destruction. A
+// loaded workspace keeps its snapshot's mapping for the task text; that is
+// safe because snapshots are replaced by rename, never rewritten in place.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat st;
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* mapped = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped != MAP_FAILED) {
+                ::madvise(mapped, st.st_size, MADV_SEQUENTIAL);
+                data = static_cast<const char*>(mapped);
+                size = static_cast<size_t>(st.st_size);
+            }
+        }
+        ::close(fd);
+    }
+    ~MappedFile() {
+        if (data) ::munmap(const_cast<char*>(data), size);
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data = nullptr;
+    size_t size = 0;
+};
+
+template <typename T>
+T read_record(const char* at) {
+    T record;
+    std::memcpy(&record, at, sizeof(T));
+    return record;
+}
+
+template <typename T>
+void append_record(std::vector<char>& out, const T& record) {
+    const char* bytes = reinterpret_cast<const char*>(&record);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+bool write_all(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+} // namespace
+
+// Word-at-a-time multiply/rotate hash: not cryptographic, but it catches torn
+// writes and bit rot while running at memory speed on multi-GB snapshots.
+std::uint64_t snapshot_checksum(const char* data, std::size_t size) {
+    const std::uint64_t prime = 0x100000001B3ULL;
+    std::uint64_t hash = 0xCBF29CE484222325ULL ^ size;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        hash = std::rotl((hash ^ word) * prime, 29);
+    }
+    for (; i < size; ++i) {
+        hash = (hash ^ static_cast<unsigned char>(data[i])) * prime;
+    }
+    return hash ^ (hash >> 32);
+}
+
+std::vector<char> encode_snapshot(const TaskManager& task_manager, const PersonManager& person_manager,
+                                  std::uint64_t journal_lsn) {
+    std::vector<const Person*> people;
+    std::vector<std::uint32_t> person_index;  // Person ID -> record index
+    person_manager.for_each_person([&](const Person* person) {
+        size_t id = static_cast<size_t>(person->get_id());
+        if (person_index.size() <= id) person_index.resize(id + 1, snapshot_no_index);
+        person_index[id] = static_cast<std::uint32_t>(people.size());
+        people.push_back(person);
+    });
+
+    // Pre-order walk with an explicit stack so arbitrarily deep trees are fine.
+    std::vector<const Task*> order;
+    std::vector<const Task*> stack;
+    task_manager.for_each_task([&](const Task* root) {
+        if (root->get_parent()) return;
+        stack.push_back(root);
+        while (!stack.empty()) {
+            const Task* task = stack.back();
+            stack.pop_back();
+            order.push_back(task);
+            auto children = task->get_children_view();
+            for (auto it = children.rbegin(); it != children.rend(); ++it) {
+                stack.push_back(*it);
+            }
+        }
+    });
+    std::vector<std::uint32_t> task_index(task_manager.get_next_id(), snapshot_no_index);
+    for (size_t i = 0; i < order.size(); ++i) {
+        task_index[order[i]->get_id()] = static_cast<std::uint32_t>(i);
+    }
+
+    size_t heap_size = 0;
+    for (const Person* person : people) heap_size += person->get_name_view().size();
+    for (const Task* task : order) heap_size += task->get_name_view().size() + task->get_description_view().size();
+
+    size_t records_size = people.size() * sizeof(PersonRecord) + order.size() * sizeof(TaskRecord);
+    std::vector<char> image;
+    image.reserve(sizeof(SnapshotHeader) + records_size + heap_size);
+    image.resize(sizeof(SnapshotHeader));
+
+    std::uint64_t heap_offset = 0;
+    for (const Person* person : people) {
+        PersonRecord record{};
+        record.name_offset = heap_offset;
+        record.name_length = static_cast<std::uint32_t>(person->get_name_view().size());
+        heap_offset += record.name_length;
+        append_record(image, record);
+    }
+    for (const Task* task : order) {
+        TaskRecord record{};
+        record.id = static_cast<std::uint32_t>(task->get_id());
+        record.parent = task->get_parent() ? task_index[task->get_parent()->get_id()] : snapshot_no_index;
+        record.owner = task->get_owner() ? person_index[task->get_owner()->get_id()] : snapshot_no_index;
+        record.status = static_cast<std::uint8_t>(task->get_status());
+        record.name_offset = heap_offset;
+        record.name_length = static_cast<std::uint32_t>(task->get_name_view().size());
+        record.description_length = static_cast<std::uint32_t>(task->get_description_view().size());
+        heap_offset += record.name_length + record.description_length;
+        append_record(image, record);
+    }
+    for (const Person* person : people) {
+        std::string_view name = person->get_name_view();
+        image.insert(image.end(), name.begin(), name.end());
+    }
+    for (const Task* task : order) {
+        std::string_view name = task->get_name_view();
+        std::string_view description = task->get_description_view();
+        image.insert(image.end(), name.begin(), name.end());
+        image.insert(image.end(), description.begin(), description.end());
+    }
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, snapshot_magic, sizeof(header.magic));
+    header.version = snapshot_version;
+    header.header_size = sizeof(SnapshotHeader);
+    header.person_count = people.size();
+    header.task_count = order.size();
+    header.string_heap_size = heap_size;
+    header.next_task_id = static_cast<std::uint32_t>(task_manager.get_next_id());
+    header.journal_lsn = journal_lsn;
+    header.checksum = snapshot_checksum(image.data() + sizeof(SnapshotHeader), image.size() - sizeof(SnapshotHeader));
+    std::memcpy(image.data(), &header, sizeof(header));
+    return image;
+}
+
+int write_snapshot_file(const std::string& path, const std::vector<char>& image) {
+    std::string temp_path = path + ".tmp";
+    int fd = ::open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "Error: Cannot create '" << temp_path << "': " << std::strerror(errno) << std::endl;
+        return 0;
+    }
+    bool ok = write_all(fd, image.data(), image.size()) && ::fsync(fd) == 0;
+    ok = (::close(fd) == 0) && ok;
+    if (!ok || ::rename(temp_path.c_str(), path.c_str()) != 0) {
+        std::cerr << "Error: Failed to write snapshot '" << path << "': " << std::strerror(errno) << std::endl;
+        ::unlink(temp_path.c_str());
+        return 0;
+    }
+    return 1;
+}
+
+int save_snapshot(const std::string& path, const TaskManager& task_manager, const PersonManager& person_manager,
+                  std::uint64_t journal_lsn) {
+    return write_snapshot_file(path, encode_snapshot(task_manager, person_manager, journal_lsn));
+}
+
+int load_snapshot(const std::string& path, TaskManager& task_manager, PersonManager& person_manager,
+                  std::uint64_t* journal_lsn) {
+    auto file = std::make_shared<const MappedFile>(path);
+    if (!file->data) {
+        std::cerr << "Error: Cannot open snapshot '" << path << "'." << std::endl;
+        return 0;
+    }
+    auto fail = [&path](const char* reason) {
+        std::cerr << "Error: Snapshot '" << path << "' is invalid: " << reason << "." << std::endl;
+        return 0;
+    };
+
+    if (file->size < sizeof(SnapshotHeader)) return fail("truncated header");
+    auto header = read_record<SnapshotHeader>(file->data);
+    if (std::memcmp(header.magic, snapshot_magic, sizeof(header.magic)) != 0) return fail("bad magic");
+    if (header.version != snapshot_version) return fail("unsupported version");
+    if (header.header_size != sizeof(SnapshotHeader)) return fail("unexpected header size");
+
+    // Sizes and offsets come from the file, so every bound is checked by
+    // subtraction: a crafted value must not wrap a sum past the check.
+    const std::uint64_t body_size = file->size - sizeof(SnapshotHeader);
+    if (header.person_count > body_size / sizeof(PersonRecord)
+        || header.task_count > (body_size - header.person_count * sizeof(PersonRecord)) / sizeof(TaskRecord)
+        || header.string_heap_size != body_size - header.person_count * sizeof(PersonRecord)
+                                                - header.task_count * sizeof(TaskRecord)) {
+        return fail("size mismatch");
+    }
+    if (header.next_task_id > static_cast<std::uint32_t>(std::numeric_limits<int>::max())) {
+        return fail("next task ID out of range");
+    }
+    if (snapshot_checksum(file->data + sizeof(SnapshotHeader), body_size) != header.checksum) {
+        return fail("checksum mismatch");
+    }
+
+    const char* person_records = file->data + sizeof(SnapshotHeader);
+    const char* task_records = person_records + header.person_count * sizeof(PersonRecord);
+    const char* heap = task_records + header.task_count * sizeof(TaskRecord);
+    const std::uint64_t heap_size = header.string_heap_size;
+    auto in_heap = [heap_size](std::uint64_t offset, std::uint64_t length) {
+        return length <= heap_size && offset <= heap_size - length;
+    };
+
+    // Validate every record, duplicates included, before touching the
+    // managers, so a bad file leaves the current workspace alone.
+    std::unordered_set<std::string_view> names;
+    names.reserve(header.person_count);
+    for (std::uint64_t i = 0; i < header.person_count; ++i) {
+        auto record = read_record<PersonRecord>(person_records + i * sizeof(PersonRecord));
+        if (!in_heap(record.name_offset, record.name_length)) return fail("person name out of range");
+        if (!names.emplace(heap + record.name_offset, record.name_length).second) return fail("duplicate person name");
+    }
+    std::vector<bool> seen_ids(header.next_task_id);
+    // Records are in hierarchy pre-order: a task's parent is the task before
+    // it or one of that task's ancestors, which together form the open path.
+    std::vector<std::uint32_t> open_path;
+    for (std::uint64_t i = 0; i < header.task_count; ++i) {
+        auto record = read_record<TaskRecord>(task_records + i * sizeof(TaskRecord));
+        if (record.id == 0 || record.id >= header.next_task_id) return fail("task ID out of range");
+        if (seen_ids[record.id]) return fail("duplicate task ID");
+        seen_ids[record.id] = true;
+        if (record.status >= Task::status_count) return fail("unknown task status");
+        while (!open_path.empty() && open_path.back() != record.parent) open_path.pop_back();
+        if (record.parent != snapshot_no_index && open_path.empty()) return fail("tasks not in hierarchy pre-order");
+        open_path.push_back(static_cast<std::uint32_t>(i));
+        if (record.owner != snapshot_no_index && record.owner >= header.person_count) return fail("owner out of range");
+        if (!in_heap(record.name_offset, std::uint64_t{record.name_length} + record.description_length)) {
+            return fail("task text out of range");
+        }
+    }
+
+    task_manager.delete_all_tasks();
+    person_manager.delete_all_people();
+    task_manager.begin_restore(static_cast<int>(header.next_task_id), file);
+
+    std::vector<Person*> people(header.person_count);
+    for (std::uint64_t i = 0; i < header.person_count; ++i) {
+        auto record = read_record<PersonRecord>(person_records + i * sizeof(PersonRecord));
+        std::string_view name(heap + record.name_offset, record.name_length);
+        person_manager.add_person(name);
+        people[i] = person_manager.find_person_by_name(name);
+    }
+
+    std::vector<Task*> tasks(header.task_count);
+    for (std::uint64_t i = 0; i < header.task_count; ++i) {
+        auto record = read_record<TaskRecord>(task_records + i * sizeof(TaskRecord));
+        const char* text = heap + record.name_offset;
+        tasks[i] = task_manager.restore_in_order(static_cast<int>(record.id),
+                                                 std::string_view(text, record.name_length),
+                                                 std::string_view(text + record.name_length, record.description_length),
+                                                 static_cast<Task::Status>(record.status),
+                                                 record.owner != snapshot_no_index ? people[record.owner] : nullptr,
+                                                 record.parent != snapshot_no_index ? tasks[record.parent] : nullptr);
+    }
+    task_manager.end_restore();
+    task_manager.reserve_ids(static_cast<int>(header.next_task_id));
+    if (journal_lsn) *journal_lsn = header.journal_lsn;
+    return 1;
+}
@@ -1,49 +1,112 @@
+#include <algorithm>
 #include <iostream>
 
 #include "task.hpp"
 #include "person.hpp"
+#include "task_observer.hpp"
+
+const char* Task::status_name(Status status) {
+    switch (status) {
+        case Status::Todo: return "Todo";
+        case Status::InProgress: return "InProgress";
+        case Status::Blocked: return "Blocked";
+        case Status::Cancelled: return "Cancelled";
+        case Status::Done: return "Done";
+    }
+    return "Unknown";
+}
+
+Task::~Task() {
+    // Drop out of the owner's task list so it never holds a dangling pointer.
+    if (owner) {
+        owner->unlink_task(this);
+    }
+    if (owns_details) {
+        delete details;
+    }
+}
 
 const std::string Task::get_name() const {
-    return name;
+    return std::string(details->name);
+}
+
+std::string_view Task::get_name_view() const {
+    return details->name;
 }
 
 void Task::set_name(const std::string& name) {
-    this->name = name;
+    details->assign(name, details->description);
 }
 
 const std::string Task::get_description() const {
-    return description;
+    return std::string(details->description);
+}
+
+std::string_view Task::get_description_view() const {
+    return details->description;
 }
 
 void Task::set_description(const std::string& description) {
-    this->description = description;
+    details->assign(details->name, description);
+}
+
+// The old block may hold one of the arguments, so it is freed last.
+void Task::Details::assign(std::string_view name, std::string_view description) {
+    auto block = std::make_unique_for_overwrite<char[]>(name.size() + description.size());
+    std::copy(name.begin(), name.end(), block.get());
+    std::copy(description.begin(), description.end(), block.get() + name.size());
+    this->name = std::string_view(block.get(), name.size());
+    this->description = std::string_view(block.get() + name.size(), description.size());
+    text = std::move(block);
 }
 
 Person* Task::get_owner() const {
     return owner;
 }
 
+// The single place where a task changes hands: both the task's owner
+// pointer and the owners' task lists are updated here.
 void Task::set_owner(Person* person) {
+    Person* old_owner = owner;
+    if (old_owner == person) return;
+    if (old_owner) {
+        old_owner->unlink_task(this);
+    }
     owner = person;
+    if (person) {
+        person->link_task(this);
+    }
+    if (observer) {
+        observer->on_owner_changed(*this, old_owner);
+    }
 }
 
 int Task::get_id() const {
     return id;
 }
 
+void Task::set_level(int level) {
+    if (this->level == level) return;
+    this->level = level;
+    if (observer) {
+        observer->on_level_changed(*this);
+    }
+}
+
 int Task::get_level() const {
     return level;
 }
 
 void Task::unown() {
-    if (owner) {
-        owner->remove_task(this);
-    }
-    owner = nullptr;
+    set_owner(nullptr);
 }
 
 void Task::set_status(Status status) {
+    Status old_status = this->status;
     this->status = status;
+    if (observer && old_status != status) {
+        observer->on_status_changed(*this, old_status);
+    }
 }
 
 Task::Status Task::get_status() const {
@@ -52,19 +115,19 @@ Task::Status Task::get_status() const {
 
 int Task::advance_status() {
     if (status == Status::Todo) {
-        status = Status::InProgress;
+        set_status(Status::InProgress);
     } else if (status == Status::InProgress) {
-        status = Status::Blocked;
+        set_status(Status::Blocked);
     } else if (status == Status::Blocked) {
-        status = Status::Cancelled;
+        set_status(Status::Cancelled);
     } else if (status == Status::Cancelled) {
-        status = Status::Done;
+        set_status(Status::Done);
     }
     return static_cast<int>(status);
 }
 
 void Task::mark_as_done() {
-    status = Status::Done;
+    set_status(Status::Done);
 }
 
 bool Task::is_done() const {
@@ -76,8 +139,12 @@ void Task::set_parent(Task* parent) {
         std::cerr << "[WARNING] Task::set_parent: self-parenting is not allowed\n";
         return;
     }
+    Task* old_parent = this->parent;
     this->parent = parent;
-    this->level = parent->get_level() + 1;
+    if (observer && old_parent != parent) {
+        observer->on_parent_changed(*this, old_parent);
+    }
+    set_level(parent ? parent->get_level() + 1 : 1);
 }
 
 Task* Task::get_parent() const {
@@ -88,9 +155,33 @@ void Task::add_child(Task* child) {
     if (child == this) {
         return;
     }
-    children.push_back(child);
+    child->details->parent_slot = static_cast<std::int32_t>(details->children.size());
+    details->children.push_back(child);
+}
+
+void Task::remove_child(Task* child) {
+    std::vector<Task*>& children = details->children;
+    std::int32_t slot = child->details->parent_slot;
+    if (slot < 0 || static_cast<size_t>(slot) >= children.size() || children[slot] != child) return;
+    Task* last = children.back();
+    children[slot] = last;
+    last->details->parent_slot = slot;
+    children.pop_back();
+    child->details->parent_slot = -1;
 }
 
 const std::vector<Task*> Task::get_children() const {
-    return children;
+    return details->children;
+}
+
+std::span<Task* const> Task::get_children_view() const {
+    return details->children;
+}
+
+void Task::set_observer(TaskObserver* observer) {
+    this->observer = observer;
+}
+
+Task::Details* Task::get_details() const {
+    return details;
 }
@@ -1,28 +1,49 @@
 #include "task_manager.hpp"
+#include "output_sink.hpp"
 #include "person.hpp"
+#include "record_writer.hpp"
+#include "task_query.hpp"
 
 #include <iostream>
 #include <algorithm>
 
 void TaskManager::delete_all_tasks() {
+    // next_id is left alone on purpose: IDs are never handed out twice.
     tasks.clear();
+    task_pool.clear();
+    details_pool.clear();
+    restored_text.reset();
+    resize_columns(0);
+    indexes = Indexes{};
+    text_index.clear();
+    text_indexed = false;
+    rollups_built = false;
 }
 
 Task* TaskManager::find_task_by_id(int id) const {
-    for (const auto& task : tasks) {
-        if (task->get_id() == id) {
-            return task.get();
-        }
+    if (id <= 0 || static_cast<size_t>(id) >= tasks.size()) {
+        return nullptr;
     }
-    return nullptr;
+    return tasks[id];
 }
 
 void TaskManager::print_all_tasks(const PrintOptions& options) const {
-    for (const auto& task : tasks) {
+    if (options.format != OutputFormat::Text) {
+        // One record per task in ID order; the parent column carries the tree.
+        RecordWriter writer(get_output(), options.format, task_columns);
+        for (const Task* task : tasks) {
+            if (task && (options.nested || !task->get_parent())) {
+                write_task_record(writer, *task);
+            }
+        }
+        return;
+    }
+    for (Task* task : tasks) {
+        if (!task) continue;  // Empty slot left by a deleted task
         // I am only sending the print request to the top-level tasks.
         // The option "nested" will determine whether they then print their children or not.
         if (!task->get_parent()) {
-            print_task(task.get(), options);
+            print_task(task, options);
         }
     }
 }
@@ -36,83 +57,241 @@ void TaskManager::print_task(int id, const PrintOptions& options) const {
     print_task(task, options);
 }
 
+// The task, then with nested its subtree in pre-order. The walk keeps no
+// stack of its own, so a chain of any depth prints without recursing.
 void TaskManager::print_task(Task* task, const PrintOptions& options) const {
     if (!task) return;
 
+    if (options.format != OutputFormat::Text) {
+        RecordWriter writer(get_output(), options.format, task_columns);
+        walk_task_tree(task, [&](const Task* next, int) {
+            write_task_record(writer, *next);
+            return options.nested;
+        });
+        return;
+    }
+    walk_task_tree(task, [&](const Task* next, int) {
+        print_task_block(next, options);
+        return options.nested;
+    });
+}
+
+void TaskManager::print_task_block(const Task* task, const PrintOptions& options) const {
+    OutputSink& out = get_output();
     int task_level = task->get_level();
     
-    print_line_indentations(task_level);
-    std::cout << "Task ID: " << task->get_id() << "\n";
+    out.indent(task_level);
+    out << "Task ID: " << task->get_id() << "\n";
 
-    print_line_indentations(task_level);
-    std::cout << "Name: " << task->get_name() << "\n";
+    out.indent(task_level);
+    out << "Name: " << task->get_name_view() << "\n";
 
-    print_line_indentations(task_level);
-    std::cout << "Level: " << task->get_level() << "\n";
+    out.indent(task_level);
+    out << "Level: " << task->get_level() << "\n";
     
-    print_line_indentations(task_level);
-    std::cout << "Status: " << static_cast<int>(task->get_status()) << "\n";
+    out.indent(task_level);
+    out << "Status: " << static_cast<int>(task->get_status()) << "\n";
     if (options.verbose) {
-        print_line_indentations(task_level);
-        std::cout << "Description: " << task->get_description() << "\n";
+        out.indent(task_level);
+        out << "Description: " << task->get_description_view() << "\n";
 
-        print_line_indentations(task_level);
+        out.indent(task_level);
         Person* owner = task->get_owner();
         if (owner) {
-            std::cout << "Owner: " << owner->get_name() << "\n";
+            out << "Owner: " << owner->get_name_view() << "\n";
         } else {
-            std::cout << "Owner: None\n";
+            out << "Owner: None\n";
         }
         
-        print_line_indentations(task_level);
+        out.indent(task_level);
         Task* parent = task->get_parent();
         if (parent) {
-            std::cout << "Parent: " << parent->get_name() << "\n";
+            out << "Parent: " << parent->get_name_view() << "\n";
         } else {
-            std::cout << "Parent: None\n";
+            out << "Parent: None\n";
+        }
+
+        // "Subtasks: 34/50 done (Todo 10, Blocked 6)"
+        out.indent(task_level);
+        const StatusCounts& counts = subtree_status_counts(task->get_id());
+        int total = 0;
+        for (std::int32_t count : counts) total += count;
+        const int done = static_cast<int>(Task::Status::Done);
+        if (total == 0) {
+            out << "Subtasks: None\n";
+        } else {
+            out << "Subtasks: " << counts[done] << "/" << total << " done";
+            const char* separator = " (";
+            for (int s = 0; s < Task::status_count; ++s) {
+                if (s == done || counts[s] == 0) continue;
+                out << separator << Task::status_name(static_cast<Task::Status>(s)) << " " << counts[s];
+                separator = ", ";
+            }
+            out << (counts[done] == total ? "\n" : ")\n");
         }
     }
 
-    std::cout << std::endl;
+    out << "\n";
+}
 
-    if (options.nested) {
-        for (const auto& child : task->get_children()) {
-            print_task(child, options);
-        }
+int TaskManager::create_task(const std::string& name, const std::string& description, Person* owner) {
+    int new_id = next_id++;
+    place_task(new_id, name, description, owner);
+    return new_id;
+}
+
+// The task is filed in the indexes once, with its final status and owner.
+Task* TaskManager::restore_task(int id, std::string_view name, std::string_view description, Task::Status status,
+                                Person* owner) {
+    if (id <= 0 || find_task_by_id(id)) {
+        return nullptr;
     }
+    Task* task = place_task(id, name, description, owner, status);
+    reserve_ids(id + 1);
+    return task;
+}
+
+void TaskManager::begin_restore(int max_id, std::shared_ptr<const void> text) {
+    reserve_slots(max_id);
+    restore_path.clear();
+    restored_text = std::move(text);
 }
 
-void TaskManager::print_line_indentations(int level) const {
-    for (int i = 0; i < level - 1; ++i) {
-        std::cout << "--"; // Indentation for task level
+// The indexes wait for end_restore; the tree is laid out as the records
+// arrive, closing the open subtrees the new task is not part of.
+Task* TaskManager::restore_in_order(int id, std::string_view name, std::string_view description,
+                                    Task::Status status, Person* owner, Task* parent) {
+    Task::Details* details = details_pool.create(Task::Details::borrowing(name, description));
+    Task* task = task_pool.create(id, details, owner, status, parent);
+    tasks[id] = task;
+    int parent_id = parent ? parent->get_id() : 0;
+    while (!restore_path.empty() && restore_path.back() != parent_id) {
+        tree.close(restore_path.back());
+        restore_path.pop_back();
     }
+    tree.open(id);
+    restore_path.push_back(id);
+    if (parent) {
+        parent->add_child(task);
+        task->set_level(parent->get_level() + 1);
+    }
+    columns.status[id] = static_cast<std::uint8_t>(status);
+    columns.owner[id] = owner ? owner->get_id() : 0;
+    columns.parent[id] = parent_id;
+    columns.level[id] = task->get_level();
+    task->set_observer(this);
+    return task;
 }
 
-int TaskManager::create_task(const std::string& name, const std::string& description, Person* owner) {
-    int new_id = tasks.size() + 1; // Simple ID generation
-    auto new_task = std::make_unique<Task>(new_id, name, description, owner);
-    tasks.push_back(std::move(new_task));
-    return new_id;
+int TaskManager::get_next_id() const {
+    return next_id;
+}
+
+void TaskManager::reserve_ids(int next_id) {
+    this->next_id = std::max(this->next_id, next_id);
+}
+
+void TaskManager::reserve_slots(int max_id) {
+    size_t size = static_cast<size_t>(max_id) + 1;
+    if (tasks.size() >= size) return;
+    tasks.resize(size);
+    resize_columns(size);
+}
+
+Task* TaskManager::place_task(int id, std::string_view name, std::string_view description, Person* owner,
+                              Task::Status status) {
+    if (tasks.size() <= static_cast<size_t>(id)) {
+        tasks.resize(id + 1);  // Slot 0 is never used
+        resize_columns(tasks.size());
+    }
+    Task::Details* details = details_pool.create(name, description);
+    Task* task = task_pool.create(id, details, owner, status);
+    tasks[id] = task;
+    columns.status[id] = static_cast<std::uint8_t>(task->get_status());
+    columns.owner[id] = owner ? owner->get_id() : 0;
+    columns.parent[id] = 0;
+    columns.level[id] = task->get_level();
+    index_insert(id);
+    tree.insert(id);
+    if (text_indexed) text_index.add(id, task->get_name_view(), task->get_description_view());
+    task->set_observer(this);
+    return task;
 }
 
+// The task's children move up into its place under its parent, or to the
+// top level, taking their subtrees with them one level up.
 int TaskManager::delete_task(int id) {
     Task* task = find_task_by_id(id);
     if (!task) {
         std::cerr << "Task with ID " << id << " not found." << std::endl;
         return 0; // Task not found
     }
-    tasks.erase(std::remove_if(tasks.begin(), tasks.end(),
-        [task](const std::unique_ptr<Task>& t) { return t.get() == task; }), tasks.end());
+    Task* parent = task->get_parent();
+    if (parent) parent->remove_child(task);
+    for (Task* child : task->get_children_view()) link_child(parent, child);
+    if (rollups_built) {
+        StatusCounts self{};
+        self[columns.status[id]] = 1;
+        add_to_ancestors(columns.parent[id], self, -1);
+    }
+    tree.erase(id);
+    reclaim_task(id);
     return 1; // Success
 }
 
-int TaskManager::assign_task(int id, Person* person) {
+// Nothing below the task outlives it, so the links between the deleted
+// tasks are left as they are; only the parent above and the owners are
+// unlinked.
+int TaskManager::delete_subtree(int id) {
     Task* task = find_task_by_id(id);
-    if (task && task->get_owner()) {
-        task->get_owner()->remove_task(task);
+    if (!task) {
+        std::cerr << "Task with ID " << id << " not found." << std::endl;
+        return 0;
+    }
+    if (Task* parent = task->get_parent()) parent->remove_child(task);
+    if (rollups_built) {
+        StatusCounts subtree = rollups[id];
+        ++subtree[columns.status[id]];
+        add_to_ancestors(columns.parent[id], subtree, -1);
     }
+    int deleted = 1;
+    tree.for_each_descendant(id, [&](int descendant, int) {
+        reclaim_task(descendant);
+        ++deleted;
+        return true;
+    });
+    reclaim_task(id);
+    tree.erase_subtree(id);
+    return deleted;
+}
+
+// Takes the task out of the slot table, the indexes and the columns and
+// gives its storage back; destroying it unlinks it from its owner.
+void TaskManager::reclaim_task(int id) {
+    Task* task = tasks[id];
+    tasks[id] = nullptr;
+    index_erase(id);
+    indexes.child_set.erase(id);
+    if (text_indexed) text_index.remove(id, task->get_name_view(), task->get_description_view());
+    clear_columns(id);
+    Task::Details* details = task->get_details();
+    task_pool.destroy(task);
+    details_pool.destroy(details);
+}
+
+int TaskManager::delete_tasks_owned_by(Person* person) {
+    int deleted = 0;
+    // Deleting a task unlinks it from its owner, so the list shrinks from the back.
+    for (auto owned = person->get_tasks_view(); !owned.empty(); owned = person->get_tasks_view()) {
+        deleted += delete_task(owned.back()->get_id());
+    }
+    return deleted;
+}
+
+int TaskManager::assign_task(int id, Person* person) {
+    Task* task = find_task_by_id(id);
     if (task && person) {
-        task->set_owner(person);
+        task->set_owner(person);  // Also moves it out of the previous owner's list
         return 1;
     } else if (!task) {
         std::cerr << "Task with ID " << id << " not found." << std::endl;
@@ -126,17 +305,14 @@ void TaskManager::unown_task(int id) {
     Task* task = find_task_by_id(id);
     if (task) {
         task->unown();
-        Person* owner = task->get_owner();
-        if (owner) {
-            owner->remove_task(task);
-        }
     } else {
         std::cerr << "Task with ID " << id << " not found." << std::endl;
     }
 }
 
 void TaskManager::unown_all_tasks() {
-    for (auto& task : tasks) {
+    for (Task* task : tasks) {
+        if (!task) continue;
         task->unown();
     }
 }
@@ -144,7 +320,9 @@ void TaskManager::unown_all_tasks() {
 int TaskManager::set_task_name(int id, const std::string& name) {
     Task* task = find_task_by_id(id);
     if (task) {
+        if (text_indexed) text_index.remove(id, task->get_name_view(), task->get_description_view());
         task->set_name(name);
+        if (text_indexed) text_index.add(id, task->get_name_view(), task->get_description_view());
         return 1;  // Success
     } else {
         std::cerr << "Task with ID " << id << " not found." << std::endl;
@@ -163,7 +341,9 @@ const std::string TaskManager::get_task_name(int id) const {
 int TaskManager::set_task_description(int id, const std::string& description) {
     Task* task = find_task_by_id(id);
     if (task) {
+        if (text_indexed) text_index.remove(id, task->get_name_view(), task->get_description_view());
         task->set_description(description);
+        if (text_indexed) text_index.add(id, task->get_name_view(), task->get_description_view());
         return 1;  // Success
     } else {
         std::cerr << "Task with ID " << id << " not found." << std::endl;
@@ -199,32 +379,500 @@ int TaskManager::mark_task_as_done(int id) {
 int TaskManager::make_child_task(int parent_id, int child_id) {
     Task* parent = find_task_by_id(parent_id);
     Task* child = find_task_by_id(child_id);
-    if (parent && child) {
-        parent->add_child(child);
-        child->set_parent(parent);
-        return 1; // Success
+    if (!parent || !child) {
+        return 0; // Failure
+    }
+    if (child->get_parent()) {
+        std::cerr << "Task with ID " << child_id << " already has a parent." << std::endl;
+        return 0;
+    }
+    if (!can_parent(parent_id, child_id)) return 0;
+    link_child(parent, child);
+    return 1; // Success
+}
+
+int TaskManager::move_task(int id, int new_parent_id) {
+    Task* task = find_task_by_id(id);
+    Task* parent = find_task_by_id(new_parent_id);
+    if (!task || (new_parent_id != 0 && !parent)) {
+        std::cerr << "Task with ID " << (task ? new_parent_id : id) << " not found." << std::endl;
+        return 0;
+    }
+    if (parent && !can_parent(new_parent_id, id)) return 0;
+    if (task->get_parent() == parent) return 1;  // Already there
+    if (task->get_parent()) task->get_parent()->remove_child(task);
+    link_child(parent, task);
+    return 1;
+}
+
+bool TaskManager::can_parent(int parent_id, int child_id) const {
+    if (parent_id == child_id) {
+        std::cerr << "A task cannot be its own parent." << std::endl;
+        return false;
+    }
+    if (tree.is_descendant(parent_id, child_id)) {
+        std::cerr << "Task with ID " << parent_id << " is under task with ID " << child_id
+                  << ", so it cannot be its parent." << std::endl;
+        return false;
     }
-    return 0; // Failure
+    return true;
+}
+
+// parent is null for the top level. The subtree is one contiguous run of
+// the tree, so its levels are renumbered in a single pre-order walk.
+void TaskManager::link_child(Task* parent, Task* child) {
+    if (parent) parent->add_child(child);
+    child->set_parent(parent);
+    int id = child->get_id();
+    tree.attach(id, parent ? parent->get_id() : 0);
+    int level = child->get_level();
+    tree.for_each_descendant(id, [&](int descendant, int depth) {
+        tasks[descendant]->set_level(level + depth);
+        return true;
+    });
 }
 
 void TaskManager::print_all_task_owners(const PrintOptions& options) const {
-    for (const auto& task : tasks) {
+    OutputSink& out = get_output();
+    for (const Task* task : tasks) {
+        if (!task) continue;
         Person* owner = task->get_owner();
         if (owner) {
-            std::cout << "Task ID: " << task->get_id() << ": " << task->get_name() << std::endl;
-            std::cout << "Owner: " << owner->get_name() << std::endl;
+            out << "Task ID: " << task->get_id() << ": " << task->get_name_view() << "\n";
+            out << "Owner: " << owner->get_name_view() << "\n";
         } else {
-            std::cout << "Task ID: " << task->get_id() << ": " << task->get_name() << " has no owner." << std::endl;
+            out << "Task ID: " << task->get_id() << ": " << task->get_name_view() << " has no owner.\n";
         }
-        std::cout << std::endl;
+        out << "\n";
     }
 }
 
 Task* TaskManager::get_task(int id) const {
-    for (const auto& task : tasks) {
-        if (task->get_id() == id) {
-            return task.get();
+    return find_task_by_id(id);
+}
+
+std::array<int, Task::status_count> TaskManager::count_tasks_by_status() const {
+    // One branch-free pass per status over a byte column; the compiler turns
+    // each of these into a vectorized compare-and-accumulate loop.
+    std::array<int, Task::status_count> counts{};
+    const std::uint8_t* status = columns.status.data();
+    const size_t size = columns.status.size();
+    for (int s = 0; s < Task::status_count; ++s) {
+        int count = 0;
+        for (size_t i = 0; i < size; ++i) {
+            count += status[i] == s;
+        }
+        counts[s] = count;
+    }
+    return counts;
+}
+
+int TaskManager::count_tasks_owned_by(int person_id) const {
+    if (person_id <= 0) return 0;  // 0 marks unowned tasks and empty slots
+    const std::int32_t* owner = columns.owner.data();
+    const size_t size = columns.owner.size();
+    int count = 0;
+    for (size_t i = 0; i < size; ++i) {
+        count += owner[i] == person_id;
+    }
+    return count;
+}
+
+namespace {
+
+// Keeps keep[i] set only where values[i] op value holds. Branch-free over a
+// flat column block, so the compiler vectorizes each case.
+template <typename T>
+void filter_block(std::uint8_t* keep, const T* values, size_t count, CompareOp op, std::int32_t value) {
+    switch (op) {
+        case CompareOp::Eq: for (size_t i = 0; i < count; ++i) keep[i] &= values[i] == value; break;
+        case CompareOp::Ne: for (size_t i = 0; i < count; ++i) keep[i] &= values[i] != value; break;
+        case CompareOp::Lt: for (size_t i = 0; i < count; ++i) keep[i] &= values[i] < value; break;
+        case CompareOp::Le: for (size_t i = 0; i < count; ++i) keep[i] &= values[i] <= value; break;
+        case CompareOp::Gt: for (size_t i = 0; i < count; ++i) keep[i] &= values[i] > value; break;
+        case CompareOp::Ge: for (size_t i = 0; i < count; ++i) keep[i] &= values[i] >= value; break;
+    }
+}
+
+bool compare(std::int32_t a, CompareOp op, std::int32_t b) {
+    switch (op) {
+        case CompareOp::Eq: return a == b;
+        case CompareOp::Ne: return a != b;
+        case CompareOp::Lt: return a < b;
+        case CompareOp::Le: return a <= b;
+        case CompareOp::Gt: return a > b;
+        case CompareOp::Ge: return a >= b;
+    }
+    return false;
+}
+
+} // namespace
+
+void TaskManager::select(const TaskQuery& query, QueryResult& result) const {
+    result.ids.clear();
+    result.examined = 0;
+
+    // Access path: the shortest candidate list that equality predicates pin
+    // down, unless scanning every slot is cheaper. A list entry costs a
+    // random read per column and a share of the sort, which measures at
+    // about 16 slots of the vectorized scan.
+    constexpr size_t list_entry_cost = 16;
+    result.access = QueryAccess::Scan;
+    size_t candidates = tasks.size();
+    size_t cost = tasks.size();
+    auto consider = [&](QueryAccess access, size_t size) {
+        if (size * list_entry_cost < cost) {
+            cost = size * list_entry_cost;
+            result.access = access;
+            candidates = size;
+        }
+    };
+    auto owned = [&](int owner, int status) {
+        return tasks_with_owner_and_status(owner, static_cast<Task::Status>(status));
+    };
+    if (query.task_id > 0) {
+        consider(QueryAccess::Id, 1);
+    }
+    if (query.owner_id >= 0 && query.status >= 0) {
+        consider(QueryAccess::OwnerStatus, owned(query.owner_id, query.status).size());
+    }
+    if (query.status >= 0) {
+        consider(QueryAccess::Status, indexes.by_status[query.status].size());
+    }
+    if (query.owner_id >= 0) {
+        size_t size = 0;
+        for (int s = 0; s < Task::status_count; ++s) size += owned(query.owner_id, s).size();
+        consider(QueryAccess::Owner, size);
+    }
+    Task* parent = find_task_by_id(query.parent_id);
+    if (query.parent_id > 0) {
+        consider(QueryAccess::Children, parent ? parent->get_children_view().size() : 0);
+    }
+    if (query.under_id > 0) {
+        // Counting stops once the subtree is too big to beat the best so far.
+        consider(QueryAccess::Subtree, tree.count_descendants(query.under_id, cost / list_entry_cost + 1));
+    }
+
+    if (result.access != QueryAccess::Scan) {
+        auto append = [&](std::span<const std::int32_t> ids) {
+            result.ids.insert(result.ids.end(), ids.begin(), ids.end());
+        };
+        switch (result.access) {
+            case QueryAccess::Id:
+                result.ids.push_back(query.task_id);
+                break;
+            case QueryAccess::Status:
+                append(indexes.by_status[query.status]);
+                break;
+            case QueryAccess::OwnerStatus:
+                append(owned(query.owner_id, query.status));
+                break;
+            case QueryAccess::Owner:
+                for (int s = 0; s < Task::status_count; ++s) append(owned(query.owner_id, s));
+                break;
+            case QueryAccess::Children:
+                // A missing parent has no children, which is why it was picked.
+                if (!parent) break;
+                for (const Task* child : parent->get_children_view()) result.ids.push_back(child->get_id());
+                break;
+            case QueryAccess::Subtree:
+                tree.for_each_descendant(query.under_id, [&](int id, int) {
+                    result.ids.push_back(id);
+                    return true;
+                });
+                break;
+            case QueryAccess::Scan:
+                break;
+        }
+        std::erase_if(result.ids, [&](int id) {
+            if (id <= 0 || static_cast<size_t>(id) >= tasks.size() || !tasks[id]) return true;
+            for (const TaskPredicate& predicate : query.predicates) {
+                if (predicate.field == TaskField::Under) {
+                    if (!tree.is_descendant(id, predicate.value)) return true;
+                    continue;
+                }
+                std::int32_t value = predicate.field == TaskField::Id ? id
+                                   : predicate.field == TaskField::Status ? columns.status[id]
+                                   : predicate.field == TaskField::Owner ? columns.owner[id]
+                                   : predicate.field == TaskField::Parent ? columns.parent[id]
+                                   : columns.level[id];
+                if (!compare(value, predicate.op, predicate.value)) return true;
+            }
+            return false;
+        });
+        std::sort(result.ids.begin(), result.ids.end());
+        result.ids.erase(std::unique(result.ids.begin(), result.ids.end()), result.ids.end());
+        result.examined = candidates;
+        return;
+    }
+
+    // Full scan: every predicate narrows a mask over a block of slots, then
+    // the survivors are collected.
+    constexpr size_t block_size = 2048;
+    std::uint8_t keep[block_size];
+    std::int32_t ids[block_size];
+    for (size_t base = 1; base < tasks.size(); base += block_size) {
+        size_t count = std::min(block_size, tasks.size() - base);
+        std::fill_n(keep, count, std::uint8_t{1});
+        filter_block(keep, columns.status.data() + base, count, CompareOp::Ne, empty_status);
+        for (const TaskPredicate& predicate : query.predicates) {
+            switch (predicate.field) {
+                case TaskField::Id:
+                    for (size_t i = 0; i < count; ++i) ids[i] = static_cast<std::int32_t>(base + i);
+                    filter_block(keep, ids, count, predicate.op, predicate.value);
+                    break;
+                case TaskField::Status:
+                    filter_block(keep, columns.status.data() + base, count, predicate.op, predicate.value);
+                    break;
+                case TaskField::Owner:
+                    filter_block(keep, columns.owner.data() + base, count, predicate.op, predicate.value);
+                    break;
+                case TaskField::Parent:
+                    filter_block(keep, columns.parent.data() + base, count, predicate.op, predicate.value);
+                    break;
+                case TaskField::Level:
+                    filter_block(keep, columns.level.data() + base, count, predicate.op, predicate.value);
+                    break;
+                case TaskField::Under:
+                    tree.filter_descendants(keep, base, count, predicate.value);
+                    break;
+            }
+        }
+        for (size_t i = 0; i < count; ++i) {
+            if (keep[i]) result.ids.push_back(static_cast<int>(base + i));
+        }
+    }
+    result.examined = tasks.size() - (tasks.empty() ? 0 : 1);
+}
+
+const TextIndex& TaskManager::get_text_index() const {
+    if (!text_indexed) {
+        for (const Task* task : tasks) {
+            if (task) text_index.add(task->get_id(), task->get_name_view(), task->get_description_view());
         }
+        text_indexed = true;
     }
-    return nullptr;
+    return text_index;
+}
+
+// Candidates come from the text index: the tasks with every trigram of
+// every word, intersected shortest list first. One- and two-letter words
+// have no trigram, so when every word is that short all tasks are
+// candidates. Each candidate is then checked against its lowercased text
+// and scored per word: 2 if the name contains it, 1 if the description
+// does, and 2 more if it is a whole word there.
+int TaskManager::search(std::string_view text, std::vector<SearchHit>& hits) const {
+    hits.clear();
+    get_text_index();
+    std::vector<std::string> terms;
+    TextIndex::tokenize(text, terms);
+    std::sort(terms.begin(), terms.end());
+    terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+    if (terms.empty()) return 0;
+
+    std::vector<std::span<const std::int32_t>> lists;
+    for (const std::string& term : terms) {
+        if (!text_index.candidate_lists(term, lists)) return static_cast<int>(terms.size());
+    }
+    std::vector<std::int32_t> ids;
+    if (lists.empty()) {
+        for (const Task* task : tasks) {
+            if (task) ids.push_back(task->get_id());
+        }
+    } else {
+        TextIndex::intersect(lists, ids);
+    }
+
+    std::string name, description;
+    auto lowercase = [](std::string& out, std::string_view in) {
+        out.assign(in);
+        for (char& c : out) {
+            if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+        }
+    };
+    for (std::int32_t id : ids) {
+        const Task* task = find_task_by_id(id);
+        if (!task) continue;
+        lowercase(name, task->get_name_view());
+        lowercase(description, task->get_description_view());
+        int score = 0;
+        for (const std::string& term : terms) {
+            bool in_name = name.find(term) != std::string::npos;
+            bool in_description = description.find(term) != std::string::npos;
+            if (!in_name && !in_description) {
+                score = 0;
+                break;
+            }
+            auto words = text_index.word_matches(term);
+            score += (in_name ? 2 : 0) + (in_description ? 1 : 0)
+                   + (std::binary_search(words.begin(), words.end(), id) ? 2 : 0);
+        }
+        if (score > 0) hits.push_back({id, score});
+    }
+    std::stable_sort(hits.begin(), hits.end(), [](const SearchHit& a, const SearchHit& b) { return a.score > b.score; });
+    return static_cast<int>(terms.size());
+}
+
+void TaskManager::resize_columns(size_t size) {
+    columns.status.resize(size, empty_status);
+    columns.owner.resize(size, 0);
+    columns.parent.resize(size, 0);
+    columns.level.resize(size, 0);
+    indexes.status_slot.resize(size, -1);
+    indexes.owner_slot.resize(size, -1);
+    rollups.resize(size, StatusCounts{});
+    tree.resize(size);
+}
+
+void TaskManager::clear_columns(int id) {
+    columns.status[id] = empty_status;
+    columns.owner[id] = 0;
+    columns.parent[id] = 0;
+    columns.level[id] = 0;
+    rollups[id] = StatusCounts{};
+}
+
+namespace {
+
+void list_push(std::vector<std::int32_t>& list, std::vector<std::int32_t>& slot, int id) {
+    slot[id] = static_cast<std::int32_t>(list.size());
+    list.push_back(id);
+}
+
+void list_erase(std::vector<std::int32_t>& list, std::vector<std::int32_t>& slot, int id) {
+    std::int32_t last = list.back();
+    list[slot[id]] = last;
+    slot[last] = slot[id];
+    list.pop_back();
+    slot[id] = -1;
+}
+
+} // namespace
+
+void TaskManager::index_insert(int id) {
+    std::int32_t owner = columns.owner[id];
+    if (indexes.by_owner_status.size() <= static_cast<size_t>(owner)) {
+        indexes.by_owner_status.resize(owner + 1);
+        indexes.owner_sets.resize(owner + 1);
+    }
+    list_push(indexes.by_status[columns.status[id]], indexes.status_slot, id);
+    list_push(indexes.by_owner_status[owner][columns.status[id]], indexes.owner_slot, id);
+    indexes.status_sets[columns.status[id]].insert(id);
+    indexes.owner_sets[owner].insert(id);
+}
+
+void TaskManager::index_erase(int id) {
+    list_erase(indexes.by_status[columns.status[id]], indexes.status_slot, id);
+    list_erase(indexes.by_owner_status[columns.owner[id]][columns.status[id]], indexes.owner_slot, id);
+    indexes.status_sets[columns.status[id]].erase(id);
+    indexes.owner_sets[columns.owner[id]].erase(id);
+}
+
+// Filing the tasks in ascending ID order leaves every index list sorted, so
+// the bitmaps are built from whole lists at the end: an owner's set from
+// its per-status lists, merged.
+void TaskManager::end_restore() {
+    for (; !restore_path.empty(); restore_path.pop_back()) tree.close(restore_path.back());
+    std::vector<std::int32_t> children;
+    for (size_t id = 1; id < tasks.size(); ++id) {
+        if (!tasks[id]) continue;
+        std::int32_t owner = columns.owner[id];
+        if (indexes.by_owner_status.size() <= static_cast<size_t>(owner)) {
+            indexes.by_owner_status.resize(owner + 1);
+            indexes.owner_sets.resize(owner + 1);
+        }
+        list_push(indexes.by_status[columns.status[id]], indexes.status_slot, static_cast<int>(id));
+        list_push(indexes.by_owner_status[owner][columns.status[id]], indexes.owner_slot, static_cast<int>(id));
+        if (columns.parent[id]) children.push_back(static_cast<std::int32_t>(id));
+    }
+    for (int status = 0; status < Task::status_count; ++status) {
+        indexes.status_sets[status].assign_sorted(indexes.by_status[status]);
+    }
+    indexes.child_set.assign_sorted(children);
+    std::vector<std::int32_t> owned;
+    for (size_t owner = 0; owner < indexes.by_owner_status.size(); ++owner) {
+        owned.clear();
+        for (const auto& list : indexes.by_owner_status[owner]) {
+            auto middle = static_cast<std::ptrdiff_t>(owned.size());
+            owned.insert(owned.end(), list.begin(), list.end());
+            std::inplace_merge(owned.begin(), owned.begin() + middle, owned.end());
+        }
+        indexes.owner_sets[owner].assign_sorted(owned);
+    }
+}
+
+const TaskManager::StatusCounts& TaskManager::subtree_status_counts(int id) const {
+    static const StatusCounts none{};
+    if (!find_task_by_id(id)) return none;
+    if (!rollups_built) build_rollups();
+    return rollups[id];
+}
+
+std::span<const std::int32_t> TaskManager::tasks_with_status(Task::Status status) const {
+    return indexes.by_status[static_cast<int>(status)];
+}
+
+std::span<const std::int32_t> TaskManager::tasks_with_owner_and_status(int person_id, Task::Status status) const {
+    if (person_id < 0 || static_cast<size_t>(person_id) >= indexes.by_owner_status.size()) return {};
+    return indexes.by_owner_status[person_id][static_cast<int>(status)];
+}
+
+// The columns still hold the old value while the task is taken out of the
+// indexes, then it is filed again under the new one.
+void TaskManager::on_status_changed(Task& task, Task::Status old_status) {
+    index_erase(task.get_id());
+    columns.status[task.get_id()] = static_cast<std::uint8_t>(task.get_status());
+    index_insert(task.get_id());
+    if (!rollups_built) return;
+    for (int at = columns.parent[task.get_id()]; at; at = columns.parent[at]) {
+        --rollups[at][static_cast<int>(old_status)];
+        ++rollups[at][static_cast<int>(task.get_status())];
+    }
+}
+
+void TaskManager::on_owner_changed(Task& task, Person*) {
+    Person* owner = task.get_owner();
+    index_erase(task.get_id());
+    columns.owner[task.get_id()] = owner ? owner->get_id() : 0;
+    index_insert(task.get_id());
+}
+
+void TaskManager::on_parent_changed(Task& task, Task* old_parent) {
+    Task* parent = task.get_parent();
+    if (rollups_built) {
+        StatusCounts subtree = rollups[task.get_id()];
+        ++subtree[static_cast<int>(task.get_status())];
+        add_to_ancestors(old_parent ? old_parent->get_id() : 0, subtree, -1);
+        add_to_ancestors(parent ? parent->get_id() : 0, subtree, 1);
+    }
+    columns.parent[task.get_id()] = parent ? parent->get_id() : 0;
+    if (parent) {
+        indexes.child_set.insert(task.get_id());
+    } else {
+        indexes.child_set.erase(task.get_id());
+    }
+}
+
+// Adds counts, times sign, to parent_id and each of its ancestors.
+void TaskManager::add_to_ancestors(int parent_id, const StatusCounts& counts, int sign) {
+    for (int at = parent_id; at; at = columns.parent[at]) {
+        for (int s = 0; s < Task::status_count; ++s) rollups[at][s] += sign * counts[s];
+    }
+}
+
+// The tree visits a task after its descendants, so its totals are complete
+// by the time they are added to its parent's.
+void TaskManager::build_rollups() const {
+    rollups.assign(tasks.size(), StatusCounts{});
+    tree.for_each_post_order([&](int id) {
+        int parent = columns.parent[id];
+        if (parent == 0) return;
+        for (int s = 0; s < Task::status_count; ++s) rollups[parent][s] += rollups[id][s];
+        ++rollups[parent][columns.status[id]];
+    });
+    rollups_built = true;
+}
+
+void TaskManager::on_level_changed(Task& task) {
+    columns.level[task.get_id()] = task.get_level();
 }
@@ -0,0 +1,126 @@
+#include "task_query.hpp"
+#include "person.hpp"
+#include "person_manager.hpp"
+#include "task.hpp"
+
+#include <charconv>
+
+namespace {
+
+bool parse_number(std::string_view text, std::int32_t& value) {
+    const char* end = text.data() + text.size();
+    auto result = std::from_chars(text.data(), end, value);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+// Splits "level<=2" into field, operator and value. Returns false if the
+// term has no operator.
+bool split_term(std::string_view term, std::string_view& field, CompareOp& op, std::string_view& value) {
+    size_t at = term.find_first_of("=!<>");
+    if (at == std::string_view::npos || at == 0) return false;
+    field = term.substr(0, at);
+    std::string_view rest = term.substr(at);
+    size_t length = 2;
+    if (rest.starts_with("<=")) {
+        op = CompareOp::Le;
+    } else if (rest.starts_with(">=")) {
+        op = CompareOp::Ge;
+    } else if (rest.starts_with("!=")) {
+        op = CompareOp::Ne;
+    } else {
+        length = 1;
+        switch (rest[0]) {
+            case '<': op = CompareOp::Lt; break;
+            case '>': op = CompareOp::Gt; break;
+            case '=': op = CompareOp::Eq; break;
+            default: return false;
+        }
+    }
+    value = rest.substr(length);
+    return true;
+}
+
+} // namespace
+
+const char* query_access_name(QueryAccess access) {
+    switch (access) {
+        case QueryAccess::Scan: return "full scan";
+        case QueryAccess::Id: return "id lookup";
+        case QueryAccess::Status: return "status index";
+        case QueryAccess::Owner: return "owner index";
+        case QueryAccess::OwnerStatus: return "owner and status index";
+        case QueryAccess::Children: return "parent's child list";
+        case QueryAccess::Subtree: return "subtree range";
+    }
+    return "unknown";
+}
+
+int compile_task_query(std::span<const std::string_view> terms, const PersonManager& people,
+                       TaskQuery& query, std::string& error) {
+    query = TaskQuery{};
+    for (std::string_view term : terms) {
+        std::string_view field_name, value;
+        CompareOp op;
+        if (!split_term(term, field_name, op, value) || value.empty()) {
+            error = "'" + std::string(term) + "' is not a <field><op><value> term";
+            return 0;
+        }
+        TaskPredicate predicate{TaskField::Id, op, 0};
+        if (field_name == "status") {
+            predicate.field = TaskField::Status;
+            int s = 0;
+            while (s < Task::status_count && value != Task::status_name(static_cast<Task::Status>(s))) ++s;
+            if (s == Task::status_count && !(parse_number(value, predicate.value) && predicate.value >= 0
+                                             && predicate.value < Task::status_count)) {
+                error = "unknown status '" + std::string(value) + "'";
+                return 0;
+            }
+            if (s < Task::status_count) predicate.value = s;
+            if (op == CompareOp::Eq) query.status = predicate.value;
+        } else if (field_name == "owner") {
+            predicate.field = TaskField::Owner;
+            const Person* owner = nullptr;
+            if (value != "none") {
+                owner = people.find_person_by_name(value);
+                if (!owner) {
+                    error = "unknown person '" + std::string(value) + "'";
+                    return 0;
+                }
+                predicate.value = owner->get_id();
+            }
+            if (op != CompareOp::Eq && op != CompareOp::Ne) {
+                error = "owner only supports = and !=";
+                return 0;
+            }
+            if (op == CompareOp::Eq) query.owner_id = predicate.value;
+        } else if (field_name == "id" || field_name == "parent" || field_name == "level") {
+            predicate.field = field_name == "id" ? TaskField::Id
+                            : field_name == "parent" ? TaskField::Parent : TaskField::Level;
+            bool none = predicate.field == TaskField::Parent && value == "none";
+            if (!none && !parse_number(value, predicate.value)) {
+                error = "'" + std::string(value) + "' is not a number";
+                return 0;
+            }
+            if (op == CompareOp::Eq && predicate.value > 0) {
+                if (predicate.field == TaskField::Id) query.task_id = predicate.value;
+                if (predicate.field == TaskField::Parent) query.parent_id = predicate.value;
+            }
+        } else if (field_name == "under") {
+            predicate.field = TaskField::Under;
+            if (op != CompareOp::Eq) {
+                error = "under only supports =";
+                return 0;
+            }
+            if (!parse_number(value, predicate.value)) {
+                error = "'" + std::string(value) + "' is not a number";
+                return 0;
+            }
+            query.under_id = predicate.value;
+        } else {
+            error = "unknown field '" + std::string(field_name) + "' (status, owner, level, parent, under or id)";
+            return 0;
+        }
+        query.predicates.push_back(predicate);
+    }
+    return 1;
+}
@@ -0,0 +1,156 @@
+#include "task_tree.hpp"
+
+#include <algorithm>
+
+namespace {
+
+// Gap left after a token appended at the end of a run, so that tasks
+// created one after another, or children added to the same parent, do not
+// halve the space before the next token every time.
+constexpr std::uint64_t spacing = std::uint64_t{1} << 32;
+
+// A label range of width 2^i may hold at most (2 / overflow)^i tokens
+// before it is spread out. Between 1 and 2; 1.3 leaves room for billions
+// of tokens in 63 bits.
+constexpr double overflow = 1.3;
+
+} // namespace
+
+void TaskTree::resize(std::size_t new_size) {
+    if (new_size == 0) {
+        next = std::vector<Token>();
+        prev = std::vector<Token>();
+        label = std::vector<std::uint64_t>();
+        return;
+    }
+    if (new_size <= size()) return;
+    bool fresh = next.empty();
+    next.resize(2 * new_size, absent);
+    prev.resize(2 * new_size, absent);
+    label.resize(2 * new_size, 0);
+    if (fresh) {
+        // The hidden root spans every label.
+        next[enter(0)] = exit(0);
+        prev[exit(0)] = enter(0);
+        label[exit(0)] = top;
+    }
+}
+
+void TaskTree::insert(int id) {
+    open(id);
+    close(id);
+}
+
+void TaskTree::erase(int id) {
+    for (Token t : {enter(id), exit(id)}) {
+        next[prev[t]] = next[t];
+        prev[next[t]] = prev[t];
+        next[t] = prev[t] = absent;
+        label[t] = 0;
+    }
+}
+
+// The run from id's enter token to its exit token is cut out in one splice,
+// then each of its tokens is cleared.
+void TaskTree::erase_subtree(int id) {
+    Token before = prev[enter(id)], after = next[exit(id)];
+    next[before] = after;
+    prev[after] = before;
+    for (Token t = enter(id); t != absent;) {
+        Token following = t == exit(id) ? absent : next[t];
+        next[t] = prev[t] = absent;
+        label[t] = 0;
+        t = following;
+    }
+}
+
+void TaskTree::attach(int id, int parent_id) {
+    scratch.clear();
+    for (Token t = enter(id); t != exit(id); t = next[t]) scratch.push_back(t);
+    scratch.push_back(exit(id));
+    Token before = prev[enter(id)], after = next[exit(id)];
+    next[before] = after;
+    prev[after] = before;
+
+    Token at = exit(parent_id);
+    Token p = prev[at];
+    std::uint64_t step = (label[at] - label[p]) / (scratch.size() + 1);
+    if (step == 0) {
+        make_room(p, scratch.size());
+        step = (label[at] - label[p]) / (scratch.size() + 1);
+    }
+    step = std::min(step, spacing);
+    std::uint64_t value = label[p];
+    for (Token t : scratch) label[t] = value += step;
+    next[p] = enter(id);
+    prev[enter(id)] = p;
+    next[exit(id)] = at;
+    prev[at] = exit(id);
+}
+
+void TaskTree::link_before(Token t, Token at) {
+    Token p = prev[at];
+    if (label[at] - label[p] < 2) make_room(p, 1);
+    label[t] = label[p] + std::min((label[at] - label[p]) / 2, spacing);
+    prev[t] = p;
+    next[t] = at;
+    next[p] = t;
+    prev[at] = t;
+}
+
+// Grows an aligned label range around t, 2^i wide for i = 1, 2, ..., until
+// it is sparse enough to take extra more tokens, then spaces the tokens in
+// it evenly with extra empty slots after t. The root's enter token has label
+// 0 and stays first; its exit token, at 2^63, lies past every range.
+void TaskTree::make_room(Token t, std::size_t extra) {
+    Token first = t, last = t;
+    std::size_t count = 1;
+    double capacity = 1.0;
+    for (int i = 1; i <= 63; ++i) {
+        std::uint64_t width = std::uint64_t{1} << i;
+        std::uint64_t lo = label[t] & ~(width - 1);
+        std::uint64_t hi = lo + width;
+        while (prev[first] != absent && label[prev[first]] >= lo) {
+            first = prev[first];
+            ++count;
+        }
+        while (label[next[last]] < hi) {
+            last = next[last];
+            ++count;
+        }
+        capacity *= 2.0 / overflow;
+        std::size_t slots = count + extra;
+        if (static_cast<double>(slots) <= capacity && width / slots >= 2) {
+            std::uint64_t step = width / slots;
+            std::uint64_t value = lo;
+            for (Token at = first;; at = next[at]) {
+                label[at] = value;
+                value += at == t ? (extra + 1) * step : step;
+                if (at == last) break;
+            }
+            relabels += count;
+            return;
+        }
+    }
+}
+
+std::size_t TaskTree::count_descendants(int id, std::size_t limit) const {
+    std::size_t count = 0;
+    for_each_descendant(id, [&](int, int) { return ++count < limit; });
+    return count;
+}
+
+void TaskTree::filter_descendants(std::uint8_t* keep, std::size_t base, std::size_t count, int ancestor_id) const {
+    if (!contains(ancestor_id)) {
+        std::fill_n(keep, count, std::uint8_t{0});
+        return;
+    }
+    // Strictly between lo and hi, as one unsigned comparison. Absent tasks
+    // have label 0 and wrap around to a large value.
+    std::uint64_t lo = label[enter(ancestor_id)];
+    std::uint64_t width = label[exit(ancestor_id)] - lo - 1;
+    const std::uint64_t* enters = label.data() + enter(static_cast<int>(base));
+    for (std::size_t i = 0; i < count; ++i) {
+        keep[i] &= enters[2 * i] - lo - 1 < width;
+    }
+}
@@ -0,0 +1,163 @@
+#include "text_index.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+bool is_token_byte(unsigned char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c >= 0x80;
+}
+
+char lower(char c) {
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+std::uint32_t pack_trigram(std::string_view word, std::size_t at) {
+    return static_cast<std::uint32_t>(static_cast<unsigned char>(word[at])) << 16
+         | static_cast<std::uint32_t>(static_cast<unsigned char>(word[at + 1])) << 8
+         | static_cast<std::uint32_t>(static_cast<unsigned char>(word[at + 2]));
+}
+
+// IDs mostly arrive in ascending order (new tasks), so this is usually a
+// push_back, and a word or trigram seen twice in one document is found at
+// the back.
+void post(std::vector<std::int32_t>& postings, std::int32_t id) {
+    if (postings.empty() || postings.back() < id) {
+        postings.push_back(id);
+        return;
+    }
+    if (postings.back() == id) return;
+    auto at = std::lower_bound(postings.begin(), postings.end(), id);
+    if (*at != id) postings.insert(at, id);
+}
+
+// Returns true once postings is empty, so the key can go too.
+bool unpost(std::vector<std::int32_t>& postings, std::int32_t id) {
+    auto at = std::lower_bound(postings.begin(), postings.end(), id);
+    if (at != postings.end() && *at == id) postings.erase(at);
+    return postings.empty();
+}
+
+} // namespace
+
+// Lowercases text into lowered and calls fn with a view of each token in it.
+template <typename Fn>
+void TextIndex::for_each_token(std::string_view text, std::string& lowered, Fn&& fn) {
+    lowered.resize(text.size());
+    std::transform(text.begin(), text.end(), lowered.begin(), [](char c) { return lower(c); });
+    std::string_view all = lowered;
+    std::size_t i = 0;
+    while (i < all.size()) {
+        while (i < all.size() && !is_token_byte(static_cast<unsigned char>(all[i]))) ++i;
+        std::size_t start = i;
+        while (i < all.size() && is_token_byte(static_cast<unsigned char>(all[i]))) ++i;
+        if (i > start) fn(all.substr(start, i - start));
+    }
+}
+
+void TextIndex::tokenize(std::string_view text, std::vector<std::string>& tokens) {
+    std::string lowered;
+    for_each_token(text, lowered, [&](std::string_view token) { tokens.emplace_back(token); });
+}
+
+// Repeats are left in: posting a document twice is a no-op, and so is
+// removing it twice. Sorting them out costs more than it saves.
+void TextIndex::collect(std::string_view name, std::string_view description) {
+    scratch_words.clear();
+    scratch_trigrams.clear();
+    auto keep = [&](std::string_view word) {
+        scratch_words.push_back(word);
+        for (std::size_t at = 0; at + 3 <= word.size(); ++at) {
+            scratch_trigrams.push_back(pack_trigram(word, at));
+        }
+    };
+    for_each_token(name, scratch_name, keep);
+    for_each_token(description, scratch_description, keep);
+}
+
+void TextIndex::add(std::int32_t id, std::string_view name, std::string_view description) {
+    collect(name, description);
+    for (std::string_view word : scratch_words) {
+        auto it = words.find(word);
+        if (it == words.end()) it = words.emplace(std::string(word), Postings()).first;
+        post(it->second, id);
+    }
+    for (std::uint32_t trigram : scratch_trigrams) {
+        post(trigrams[trigram], id);
+    }
+}
+
+void TextIndex::remove(std::int32_t id, std::string_view name, std::string_view description) {
+    collect(name, description);
+    for (std::string_view word : scratch_words) {
+        auto it = words.find(word);
+        if (it != words.end() && unpost(it->second, id)) words.erase(it);
+    }
+    for (std::uint32_t trigram : scratch_trigrams) {
+        auto it = trigrams.find(trigram);
+        if (it != trigrams.end() && unpost(it->second, id)) trigrams.erase(it);
+    }
+}
+
+void TextIndex::clear() {
+    words.clear();
+    trigrams.clear();
+}
+
+std::span<const std::int32_t> TextIndex::word_matches(std::string_view term) const {
+    auto it = words.find(term);
+    if (it == words.end()) return {};
+    return it->second;
+}
+
+bool TextIndex::candidate_lists(std::string_view term,
+                                std::vector<std::span<const std::int32_t>>& lists) const {
+    if (term.size() < 3) return true;  // No trigram to narrow by
+    for (std::size_t at = 0; at + 3 <= term.size(); ++at) {
+        auto it = trigrams.find(pack_trigram(term, at));
+        if (it == trigrams.end()) return false;
+        lists.push_back(it->second);
+    }
+    return true;
+}
+
+// Shortest list first. Lists of similar length are merged; against a much
+// longer list each survivor is found by a binary search that starts where
+// the previous one ended.
+void TextIndex::intersect(std::vector<std::span<const std::int32_t>>& lists, std::vector<std::int32_t>& ids) {
+    ids.clear();
+    if (lists.empty()) return;
+    std::sort(lists.begin(), lists.end(), [](auto a, auto b) { return a.size() < b.size(); });
+    ids.assign(lists.front().begin(), lists.front().end());
+    std::vector<std::int32_t> kept;
+    for (std::size_t i = 1; i < lists.size() && !ids.empty(); ++i) {
+        std::span<const std::int32_t> other = lists[i];
+        kept.clear();
+        if (other.size() / 16 < ids.size()) {
+            std::set_intersection(ids.begin(), ids.end(), other.begin(), other.end(), std::back_inserter(kept));
+        } else {
+            auto from = other.begin();
+            for (std::int32_t id : ids) {
+                from = std::lower_bound(from, other.end(), id);
+                if (from == other.end()) break;
+                if (*from == id) kept.push_back(id);
+            }
+        }
+        ids.swap(kept);
+    }
+}
+
+std::size_t TextIndex::memory_bytes() const {
+    // Each hash node holds the key, the vector and a next pointer; the
+    // bucket array adds one pointer per bucket.
+    std::size_t bytes = (words.bucket_count() + trigrams.bucket_count()) * sizeof(void*);
+    for (const auto& [word, postings] : words) {
+        bytes += sizeof(void*) + sizeof(std::string) + sizeof(Postings) + postings.capacity() * sizeof(std::int32_t);
+        if (word.capacity() > 15) bytes += word.capacity() + 1;  // Past the small-string buffer
+    }
+    for (const auto& [trigram, postings] : trigrams) {
+        bytes += sizeof(void*) + sizeof(std::uint32_t) + sizeof(Postings) + postings.capacity() * sizeof(std::int32_t);
+    }
+    return bytes;
+}
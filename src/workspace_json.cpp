@@ -0,0 +1,342 @@
+#include "workspace_json.hpp"
+#include "json_stream.hpp"
+#include "person.hpp"
+#include "person_manager.hpp"
+#include "task.hpp"
+#include "task_manager.hpp"
+
+#include <charconv>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr int json_format_version = 1;
+
+// Builds the workspace from SAX events, one person or task element at a
+// time. Depth 1 is the document object, depth 2 the "people"/"tasks" arrays
+// and depth 3 their elements; anything the format does not know about is
+// skipped whole.
+class WorkspaceImporter : public JsonHandler {
+public:
+    WorkspaceImporter(TaskManager& task_manager, PersonManager& person_manager)
+        : task_manager(task_manager), person_manager(person_manager) {}
+
+    bool on_begin_object() override {
+        ++depth;
+        if (skip_from) return true;
+        if (depth == 3) {
+            record = Record{};
+            return true;
+        }
+        return depth == 1 ? true : skip();
+    }
+
+    bool on_end_object() override {
+        bool ok = true;
+        if (!skip_from && depth == 3) {
+            ok = section == Section::People ? finish_person() : finish_task();
+        }
+        close_container();
+        return ok;
+    }
+
+    bool on_begin_array() override {
+        ++depth;
+        if (skip_from) return true;
+        if (depth == 1) return error("expected an object");
+        if (depth == 2 && key == Key::People) {
+            section = Section::People;
+        } else if (depth == 2 && key == Key::Tasks) {
+            section = Section::Tasks;
+        } else {
+            return skip();
+        }
+        return true;
+    }
+
+    bool on_end_array() override {
+        if (!skip_from && depth == 2) section = Section::None;
+        close_container();
+        return true;
+    }
+
+    bool on_key(std::string_view name) override {
+        if (skip_from) return true;
+        key = name == "id" ? Key::Id
+            : name == "name" ? Key::Name
+            : name == "description" ? Key::Description
+            : name == "status" ? Key::Status
+            : name == "owner" ? Key::Owner
+            : name == "parent" ? Key::Parent
+            : name == "people" ? Key::People
+            : name == "tasks" ? Key::Tasks
+            : name == "version" ? Key::Version
+            : name == "next_task_id" ? Key::NextTaskId
+            : Key::Other;
+        return true;
+    }
+
+    bool on_string(std::string_view text) override {
+        if (skip_from) return true;
+        if (depth == 1) {
+            return key != Key::Version && key != Key::NextTaskId ? true : error("expected a number");
+        }
+        if (depth != 3) return error("expected an object");
+        switch (key) {
+        case Key::Name: record.name.assign(text); break;
+        case Key::Description: record.description.assign(text); break;
+        case Key::Owner: record.owner.assign(text); record.has_owner = true; break;
+        case Key::Status:
+            for (int s = 0; s < Task::status_count; ++s) {
+                if (text == Task::status_name(static_cast<Task::Status>(s))) {
+                    record.status = static_cast<Task::Status>(s);
+                    return true;
+                }
+            }
+            return error("unknown status '" + std::string(text) + "'");
+        case Key::Id:
+        case Key::Parent:
+            return error("expected a number");
+        default:
+            break;
+        }
+        return true;
+    }
+
+    bool on_number(std::string_view text) override {
+        if (skip_from) return true;
+        long long number = 0;
+        auto result = std::from_chars(text.data(), text.data() + text.size(), number);
+        bool integral = result.ec == std::errc() && result.ptr == text.data() + text.size();
+        if (depth == 1) {
+            if (key == Key::Version) {
+                if (!integral || number != json_format_version) return error("unsupported version");
+            } else if (key == Key::NextTaskId) {
+                if (!integral || number < 1 || number > max_id) return error("bad next_task_id");
+                next_task_id = static_cast<int>(number);
+            }
+            return true;
+        }
+        if (depth != 3) return error("expected an object");
+        if (key != Key::Id && key != Key::Parent && key != Key::Status) return true;
+        if (!integral || number < 0 || number > max_id) return error("bad number '" + std::string(text) + "'");
+        if (key == Key::Id) {
+            record.id = static_cast<int>(number);
+        } else if (key == Key::Parent) {
+            record.parent = static_cast<int>(number);
+        } else if (number < Task::status_count) {
+            record.status = static_cast<Task::Status>(number);
+        } else {
+            return error("unknown status " + std::string(text));
+        }
+        return true;
+    }
+
+    bool on_bool(bool) override {
+        return skip_from || depth == 1 || depth == 3 ? true : error("expected an object");
+    }
+
+    bool on_null() override {
+        if (skip_from) return true;
+        if (depth != 1 && depth != 3) return error("expected an object");
+        if (depth == 3 && key == Key::Owner) record.has_owner = false;
+        if (depth == 3 && key == Key::Parent) record.parent = 0;
+        return true;
+    }
+
+    // Links the parents that were listed after their children. Returns 1 on success.
+    int finish() {
+        for (auto [child_id, parent_id] : forward_parents) {
+            const Task* parent = task_manager.get_task(parent_id);
+            if (!parent) {
+                return error("task " + std::to_string(child_id) + " has unknown parent " + std::to_string(parent_id));
+            }
+            // Only forward links can close a cycle, so they are the only ones checked.
+            if (task_manager.is_descendant(parent_id, child_id)) {
+                return error("task " + std::to_string(child_id) + " is its own ancestor");
+            }
+            if (!task_manager.make_child_task(parent_id, child_id)) {
+                return error("cannot make task " + std::to_string(child_id) + " a child of task "
+                             + std::to_string(parent_id));
+            }
+        }
+        task_manager.reserve_ids(next_task_id);
+        return 1;
+    }
+
+    const std::string& get_error() const { return error_message; }
+    int get_task_count() const { return task_count; }
+
+private:
+    enum class Section { None, People, Tasks };
+    enum class Key { Other, Id, Name, Description, Status, Owner, Parent, People, Tasks, Version, NextTaskId };
+
+    struct Record {
+        int id = 0;
+        int parent = 0;
+        Task::Status status = Task::Status::Todo;
+        bool has_owner = false;
+        std::string name, description, owner;
+    };
+
+    static constexpr long long max_id = 0x7FFFFFFE;
+
+    void close_container() {
+        if (skip_from == depth) skip_from = 0;
+        --depth;
+    }
+
+    // Ignores the container just opened, and everything inside it.
+    bool skip() {
+        skip_from = depth;
+        return true;
+    }
+
+    bool error(const std::string& message) {
+        error_message = message;
+        return false;
+    }
+
+    bool finish_person() {
+        if (record.name.empty()) return error("person without a name");
+        if (!person_manager.add_person(record.name)) return error("duplicate person '" + record.name + "'");
+        return true;
+    }
+
+    bool finish_task() {
+        if (record.id <= 0) return error("task without an id");
+        Person* owner = nullptr;
+        if (record.has_owner) {
+            owner = person_manager.find_person_by_name(record.owner);
+            if (!owner) return error("task " + std::to_string(record.id) + " has unknown owner '" + record.owner + "'");
+        }
+        int id = record.id;
+        Task* task = task_manager.restore_task(id, record.name, record.description, record.status, owner);
+        if (!task) return error("duplicate task id " + std::to_string(id));
+        if (record.parent == id) return error("task " + std::to_string(id) + " is its own parent");
+        if (record.parent > 0) {
+            if (task_manager.get_task(record.parent)) {
+                if (!task_manager.make_child_task(record.parent, id)) {
+                    return error("cannot make task " + std::to_string(id) + " a child of task "
+                                 + std::to_string(record.parent));
+                }
+            } else {
+                forward_parents.emplace_back(id, record.parent);
+            }
+        }
+        ++task_count;
+        return true;
+    }
+
+    TaskManager& task_manager;
+    PersonManager& person_manager;
+    int depth = 0;
+    int skip_from = 0;  // Depth of the container being skipped, 0 when not skipping
+    Section section = Section::None;
+    Key key = Key::Other;
+    Record record;
+    int next_task_id = 1;
+    int task_count = 0;
+    std::vector<std::pair<int, int>> forward_parents;  // (child, parent) pairs to link at the end
+    std::string error_message;
+};
+
+void write_task(JsonWriter& writer, const Task* task) {
+    writer.begin_object();
+    writer.key("id");
+    writer.value(std::int64_t{task->get_id()});
+    writer.key("name");
+    writer.value(task->get_name_view());
+    writer.key("description");
+    writer.value(task->get_description_view());
+    writer.key("status");
+    writer.value(Task::status_name(task->get_status()));
+    writer.key("owner");
+    if (task->get_owner()) {
+        writer.value(task->get_owner()->get_name_view());
+    } else {
+        writer.null();
+    }
+    writer.key("parent");
+    if (task->get_parent()) {
+        writer.value(std::int64_t{task->get_parent()->get_id()});
+    } else {
+        writer.null();
+    }
+    writer.end_object();
+}
+
+} // namespace
+
+int export_json(std::ostream& out, const TaskManager& task_manager, const PersonManager& person_manager) {
+    {
+        JsonWriter writer(out);
+        writer.begin_object();
+        writer.key("format");
+        writer.value("taskcli");
+        writer.key("version");
+        writer.value(std::int64_t{json_format_version});
+        writer.key("next_task_id");
+        writer.value(std::int64_t{task_manager.get_next_id()});
+
+        writer.key("people");
+        writer.begin_array();
+        person_manager.for_each_person([&](const Person* person) {
+            writer.begin_object();
+            writer.key("name");
+            writer.value(person->get_name_view());
+            writer.end_object();
+        });
+        writer.end_array();
+
+        // Pre-order with an explicit stack, written as it is walked.
+        writer.key("tasks");
+        writer.begin_array();
+        std::vector<const Task*> stack;
+        task_manager.for_each_task([&](const Task* root) {
+            if (root->get_parent()) return;
+            stack.push_back(root);
+            while (!stack.empty()) {
+                const Task* task = stack.back();
+                stack.pop_back();
+                write_task(writer, task);
+                auto children = task->get_children_view();
+                for (auto it = children.rbegin(); it != children.rend(); ++it) {
+                    stack.push_back(*it);
+                }
+            }
+        });
+        writer.end_array();
+        writer.end_object();
+    }
+    out << '\n';
+    out.flush();
+    if (!out) {
+        std::cerr << "Error: Failed to write the JSON export." << std::endl;
+        return 0;
+    }
+    return 1;
+}
+
+int import_json(std::istream& in, TaskManager& task_manager, PersonManager& person_manager) {
+    task_manager.delete_all_tasks();
+    person_manager.delete_all_people();
+
+    WorkspaceImporter importer(task_manager, person_manager);
+    JsonParser parser(in);
+    // The parser's own errors name the byte already; the importer's, raised
+    // while parsing, get it added, and the ones from finish() have none.
+    std::string reason;
+    if (!parser.parse(importer)) {
+        reason = parser.error().empty() ? importer.get_error() + " at byte " + std::to_string(parser.bytes_read())
+                                        : parser.error();
+    } else if (!importer.finish()) {
+        reason = importer.get_error();
+    } else {
+        return 1;
+    }
+    std::cerr << "Error: Invalid workspace JSON: " << reason << "." << std::endl;
+    return 0;
+}
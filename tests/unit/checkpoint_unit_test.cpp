@@ -0,0 +1,163 @@
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+#include "checkpoint.hpp"
+#include "journal.hpp"
+#include "person_manager.hpp"
+#include "person.hpp"
+#include "snapshot.hpp"
+#include "task_manager.hpp"
+#include "task.hpp"
+
+// --- Tiny assert helpers ---
+#define ASSERT_TRUE(cond) do { \
+    if(!(cond)) { \
+        std::cerr << "[FAIL] " << __FILE__ << ":" << __LINE__ \
+                  << " ASSERT_TRUE(" << #cond << ")\n"; \
+        return 1; \
+    } \
+} while(0)
+
+#define ASSERT_EQ(a,b) do { \
+    if(!((a) == (b))) { \
+        std::cerr << "[FAIL] " << __FILE__ << ":" << __LINE__ \
+                  << " ASSERT_EQ(" << #a << "," << #b << ") got (" \
+                  << (a) << "," << (b) << ")\n"; \
+        return 1; \
+    } \
+} while(0)
+
+static const std::string snapshot_file = "checkpoint_unit_test.snapshot";
+static const std::string journal_file = snapshot_file + ".journal";
+
+static void cleanup() {
+    std::remove(snapshot_file.c_str());
+    std::remove(journal_file.c_str());
+    std::remove((journal_file + ".old").c_str());
+}
+
+static void add_task(TaskManager& tm, Journal& journal, const std::string& name) {
+    int id = tm.create_task(name, "", nullptr);
+    journal.append(JournalOp::TaskAdd, id, name, "", "");
+}
+
+// Restarts the way main() does: snapshot, then the journal on top.
+static int recover(TaskManager& tm, PersonManager& pm, Journal& journal) {
+    std::uint64_t lsn = 0;
+    std::FILE* exists = std::fopen(snapshot_file.c_str(), "rb");
+    if (exists) {
+        std::fclose(exists);
+        if (!load_snapshot(snapshot_file, tm, pm, &lsn)) return 0;
+    }
+    return journal.open(journal_file, tm, pm, lsn);
+}
+
+// --- Tests ---
+int test_background_checkpoint_keeps_new_commands() {
+    cleanup();
+    {
+        TaskManager tm;
+        PersonManager pm;
+        Journal journal;
+        ASSERT_EQ(journal.open(journal_file, tm, pm), 1);
+        Checkpointer checkpointer(tm, pm, journal);
+        checkpointer.set_snapshot_path(snapshot_file);
+        add_task(tm, journal, "Before 1");
+        add_task(tm, journal, "Before 2");
+
+        ASSERT_EQ(checkpointer.start(), 1);
+        ASSERT_EQ(journal.get_size(), sizeof(JournalHeader));  // Rotated
+        add_task(tm, journal, "During");  // Served while the snapshot is written
+        checkpointer.wait();
+
+        ASSERT_EQ(checkpointer.get_stats().completed, 1);
+        ASSERT_EQ(checkpointer.get_stats().last_lsn, 2u);
+        ASSERT_TRUE(checkpointer.get_stats().last_stall_ms <= checkpointer.get_stats().last_duration_ms);
+        std::FILE* old = std::fopen((journal_file + ".old").c_str(), "rb");
+        ASSERT_TRUE(old == nullptr);
+    }
+
+    TaskManager tm;
+    PersonManager pm;
+    Journal journal;
+    ASSERT_EQ(recover(tm, pm, journal), 1);
+    ASSERT_EQ(journal.get_replayed_count(), 1u);  // Only "During" came from the journal
+    ASSERT_EQ(tm.get_task(1)->get_name(), "Before 1");
+    ASSERT_EQ(tm.get_task(3)->get_name(), "During");
+    ASSERT_EQ(journal.get_last_lsn(), 3u);
+    cleanup();
+    return 0;
+}
+
+int test_unfinished_checkpoint_replays_rotated_journal() {
+    cleanup();
+    {
+        TaskManager tm;
+        PersonManager pm;
+        Journal journal;
+        ASSERT_EQ(journal.open(journal_file, tm, pm), 1);
+        add_task(tm, journal, "Old");
+        // Crash after the rotation but before the snapshot was written.
+        ASSERT_EQ(journal.rotate(), 1);
+        ASSERT_EQ(journal.rotate(), 0);  // The first rotation is still pending
+        add_task(tm, journal, "New");
+    }
+
+    TaskManager tm;
+    PersonManager pm;
+    Journal journal;
+    ASSERT_EQ(recover(tm, pm, journal), 1);
+    ASSERT_EQ(journal.get_replayed_count(), 2u);
+    ASSERT_EQ(tm.get_task(1)->get_name(), "Old");
+    ASSERT_EQ(tm.get_task(2)->get_name(), "New");
+
+    // A synchronous checkpoint clears both files.
+    Checkpointer checkpointer(tm, pm, journal);
+    checkpointer.set_snapshot_path(snapshot_file);
+    ASSERT_EQ(checkpointer.run(), 1);
+    ASSERT_EQ(journal.get_size(), sizeof(JournalHeader));
+    std::FILE* old = std::fopen((journal_file + ".old").c_str(), "rb");
+    ASSERT_TRUE(old == nullptr);
+    cleanup();
+    return 0;
+}
+
+int test_size_threshold_triggers_checkpoint() {
+    cleanup();
+    TaskManager tm;
+    PersonManager pm;
+    Journal journal;
+    ASSERT_EQ(journal.open(journal_file, tm, pm), 1);
+    Checkpointer checkpointer(tm, pm, journal);
+    checkpointer.set_snapshot_path(snapshot_file);
+    checkpointer.set_thresholds(200, 0);
+
+    checkpointer.poll();
+    ASSERT_TRUE(!checkpointer.is_running());  // Empty journal
+    for (int i = 0; i < 10; ++i) {
+        add_task(tm, journal, "Task " + std::to_string(i));
+        checkpointer.poll();
+    }
+    checkpointer.wait();
+    ASSERT_TRUE(checkpointer.get_stats().completed >= 1);
+    ASSERT_TRUE(journal.get_size() < 200);
+    cleanup();
+    return 0;
+}
+
+// --- Main runner ---
+int main() {
+    int fails = 0;
+    fails += test_background_checkpoint_keeps_new_commands();
+    fails += test_unfinished_checkpoint_replays_rotated_journal();
+    fails += test_size_threshold_triggers_checkpoint();
+
+    if (fails == 0) {
+        std::cout << "[checkpoint_unit_test] All tests passed\n";
+        return 0;
+    } else {
+        std::cout << "[checkpoint_unit_test] " << fails << " tests failed\n";
+        return 1;
+    }
+}
@@ -0,0 +1,114 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "command_table.hpp"
+
+// --- Tiny assert helpers ---
+#define ASSERT_TRUE(cond) do { \
+    if(!(cond)) { \
+        std::cerr << "[FAIL] " << __FILE__ << ":" << __LINE__ \
+                  << " ASSERT_TRUE(" << #cond << ")\n"; \
+        return 1; \
+    } \
+} while(0)
+
+#define ASSERT_EQ(a,b) do { \
+    if(!((a) == (b))) { \
+        std::cerr << "[FAIL] " << __FILE__ << ":" << __LINE__ \
+                  << " ASSERT_EQ(" << #a << "," << #b << ") got (" \
+                  << (a) << "," << (b) << ")\n"; \
+        return 1; \
+    } \
+} while(0)
+
+static int last_run = 0;
+static int run_first(CommandArgs) { return last_run = 1; }
+static int run_second(CommandArgs args) { return last_run = 2 + static_cast<int>(args.size()); }
+
+static constexpr CommandTable table(std::to_array<CommandSpec>({
+    {"add", "<name>", "Add", 1, run_first},
+    {"advance-status", "<task_id>", "Advance", 1, run_second},
+    {"list", "[-v:verbose]", "List", 0, run_first},
+    {"list-one", "<name> [-v:verbose]", "List one", 1, run_second},
+    {"list-tasks", "<name>", "List tasks", 1, run_first},
+    {"list-tasks-count", "", "Count", 0, run_second},
+    {"set-name", "<task_id> <new_name>", "Rename", 2, run_first},
+    {"set-description", "<task_id> <new_description>", "Describe", 2, run_second},
+}));
+
+// Lookups work at compile time too.
+static_assert(table.find("list-one") && table.find("list-one")->min_args == 1);
+static_assert(!table.find("list-on"));
+
+// --- Tests ---
+int test_finds_every_command() {
+    for (const CommandSpec& command : table) {
+        const CommandSpec* found = table.find(command.name);
+        ASSERT_TRUE(found != nullptr);
+        ASSERT_EQ(found->name, command.name);
+    }
+    const std::string_view args[] = {"a", "b"};
+    ASSERT_EQ(table.find("set-description")->run(CommandArgs(args)), 4);
+    ASSERT_EQ(last_run, 4);
+    return 0;
+}
+
+int test_rejects_unknown_names() {
+    const char* unknown[] = {"", "ad", "add ", "ADD", "set--nae", "list-tasks-counts", "help"};
+    for (const char* name : unknown) {
+        ASSERT_TRUE(table.find(name) == nullptr);
+    }
+    return 0;
+}
+
+int test_usage_width() {
+    // "set-description <task_id> <new_description>"
+    ASSERT_EQ(table.usage_width(), 43u);
+    return 0;
+}
+
+int test_parse_int() {
+    int value = 0;
+    ASSERT_TRUE(parse_int("42", value));
+    ASSERT_EQ(value, 42);
+    ASSERT_TRUE(parse_int("-7", value));
+    ASSERT_EQ(value, -7);
+    ASSERT_TRUE(!parse_int("", value));
+    ASSERT_TRUE(!parse_int("12abc", value));
+    ASSERT_TRUE(!parse_int("abc", value));
+    ASSERT_TRUE(!parse_int(" 1", value));
+    ASSERT_TRUE(!parse_int("99999999999", value));
+    return 0;
+}
+
+int test_parse_uint64() {
+    std::uint64_t value = 0;
+    ASSERT_TRUE(parse_uint64("67108864", value));
+    ASSERT_EQ(value, 67108864u);
+    ASSERT_TRUE(parse_uint64("18446744073709551615", value));
+    ASSERT_EQ(value, ~std::uint64_t{0});
+    ASSERT_TRUE(!parse_uint64("18446744073709551616", value));
+    ASSERT_TRUE(!parse_uint64("-1", value));
+    ASSERT_TRUE(!parse_uint64("", value));
+    ASSERT_TRUE(!parse_uint64("1k", value));
+    return 0;
+}
+
+// --- Main runner ---
+int main() {
+    int fails = 0;
+    fails += test_finds_every_command();
+    fails += test_rejects_unknown_names();
+    fails += test_usage_width();
+    fails += test_parse_int();
+    fails += test_parse_uint64();
+
+    if (fails == 0) {
+        std::cout << "[command_table_unit_test] All tests passed\n";
+        return 0;
+    } else {
+        std::cout << "[command_table_unit_test] " << fails << " tests failed\n";
+        return 1;
+    }
+}
@@ -0,0 +1,106 @@
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "command_tokenizer.hpp"
+
+// --- Tiny assert helpers ---
+#define ASSERT_TRUE(cond) do { \
+    if(!(cond)) { \
+        std::cerr << "[FAIL] " << __FILE__ << ":" << __LINE__ \
+                  << " ASSERT_TRUE(" << #cond << ")\n"; \
+        return 1; \
+    } \
+} while(0)
+
+#define ASSERT_EQ(a,b) do { \
+    if(!((a) == (b))) { \
+        std::cerr << "[FAIL] " << __FILE__ << ":" << __LINE__ \
+                  << " ASSERT_EQ(" << #a << "," << #b << ") got (" \
+                  << (a) << "," << (b) << ")\n"; \
+        return 1; \
+    } \
+} while(0)
+
+// The way command lines used to be split.
+static std::vector<std::string> split_with_quoted(const std::string& line) {
+    std::istringstream iss(line);
+    std::vector<std::string> tokens;
+    std::string token;
+    while (iss >> std::quoted(token)) {
+        tokens.push_back(token);
+    }
+    return tokens;
+}
+
+static std::vector<std::string> split(CommandTokenizer& tokenizer, const std::string& line) {
+    std::vector<std::string> tokens;
+    for (std::string_view token : tokenizer.tokenize(line)) {
+        tokens.emplace_back(token);
+    }
+    return tokens;
+}
+
+// --- Tests ---
+int test_matches_std_quoted() {
+    const std::string lines[] = {
+        "task add -n \"Write the report\" -d \"due \\\"Friday\\\"\" -o alice",
+        "  person   rename\t\"Bob Smith\"  bob  ",
+        "task set-name 3 \"back\\\\slash\"",
+        "task add -n \"\" -d x",
+        "a\"b c\" \"d\"e",
+        "",
+        "   \t ",
+    };
+    CommandTokenizer tokenizer;
+    for (const std::string& line : lines) {
+        std::vector<std::string> expected = split_with_quoted(line);
+        std::vector<std::string> actual = split(tokenizer, line);
+        ASSERT_EQ(actual.size(), expected.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            ASSERT_EQ(actual[i], expected[i]);
+        }
+    }
+    return 0;
+}
+
+// std::quoted fails on an unterminated quote and the token was lost; here it
+// runs to the end of the line.
+int test_unterminated_quote_runs_to_end_of_line() {
+    CommandTokenizer tokenizer;
+    std::vector<std::string> tokens = split(tokenizer, "task add -n \"never closed");
+    ASSERT_EQ(tokens.size(), 4u);
+    ASSERT_EQ(tokens[3], "never closed");
+    return 0;
+}
+
+int test_tokens_view_the_tokenizer_buffer() {
+    CommandTokenizer tokenizer;
+    std::string line = "task add -n \"two words\"";
+    auto tokens = tokenizer.tokenize(line);
+    ASSERT_EQ(tokens.size(), 4u);
+    ASSERT_EQ(tokens[3], "two words");
+    line.assign(line.size(), '#');  // The caller's line may change or go away
+    ASSERT_EQ(tokens[0], "task");
+    ASSERT_EQ(tokens[3], "two words");
+    return 0;
+}
+
+// --- Main runner ---
+int main() {
+    int fails = 0;
+    fails += test_matches_std_quoted();
+    fails += test_unterminated_quote_runs_to_end_of_line();
+    fails += test_tokens_view_the_tokenizer_buffer();
+
+    if (fails == 0) {
+        std::cout << "[command_tokenizer_unit_test] All tests passed\n";
+        return 0;
+    } else {
+        std::cout << "[command_tokenizer_unit_test] " << fails << " tests failed\n";
+        return 1;
+    }
+}
@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include "id_bitmap.hpp"
+
+// --- Tiny assert helpers ---
+#define ASSERT_TRUE(cond) do { \
+    if(!(cond)) { \
+        std::cerr << "[FAIL] " << __FILE__ << ":" << __LINE__ \
+                  << " ASSERT_TRUE(" << #cond << ")\n"; \
+        return 1; \
+    } \
+} while(0)
+
+#define ASSERT_EQ(a,b) do { \
+    if(!((a) == (b))) { \
+        std::cerr << "[FAIL] " << __FILE__ << ":" << __LINE__ \
+                  << " ASSERT_EQ(" << #a << "," << #b << ") got (" \
+                  << (a) << "," << (b) << ")\n"; \
+        return 1; \
+    } \
+} while(0)
+
+static std::vector<std::uint32_t> ids_of(const IdBitmap& bitmap) {
+    std::vector<std::uint32_t> ids;
+    bitmap.for_each([&](std::uint32_t id) { ids.push_back(id); });
+    return ids;
+}
+
+// Random inserts and erases over three chunks, dense enough for chunks to
+// turn into bitsets and back, checked against std::set.
+static void fill(IdBitmap& bitmap, std::set<std::uint32_t>& reference, std::mt19937& rng, int percent_set) {
+    std::uniform_int_distribution<std::uint32_t> id(0, 3 * 65536 - 1);
+    std::uniform_int_distribution<int> percent(0, 99);
+    for (int i = 0; i < 200000; ++i) {
+        std::uint32_t value = id(rng);
+        if (percent(rng) < percent_set) {
+            bitmap.insert(value);
+            reference.insert(value);
+        } else {
+            bitmap.erase(value);
+            reference.erase(value);
+        }
+    }
+}
+
+// --- Tests ---
+int test_matches_a_set() {
+    std::mt19937 rng(7);
+    IdBitmap bitmap;
+    std::set<std::uint32_t> reference;
+    for (int percent_set : {90, 20, 60}) {
+        fill(bitmap, reference, rng, percent_set);
+        ASSERT_EQ(bitmap.count(), reference.size());
+        ASSERT_TRUE(ids_of(bitmap) == std::vector<std::uint32_t>(reference.begin(), reference.end()));
+    }
+    for (std::uint32_t id = 0; id < 3 * 65536; id += 97) {
+        ASSERT_EQ(bitmap.contains(id), reference.count(id) == 1);
+    }
+    ASSERT_TRUE(!bitmap.insert(*reference.begin()));
+    ASSERT_TRUE(!bitmap.erase(3 * 65536 + 5));
+    bitmap.clear();
+    ASSERT_TRUE(bitmap.empty());
+    ASSERT_EQ(bitmap.memory_bytes(), 0u);
+    return 0;
+}
+
+int test_set_algebra() {
+    std::mt19937 rng(11);
+    IdBitmap a, b;
+    std::set<std::uint32_t> ra, rb;
+    fill(a, ra, rng, 80);  // Mostly bitset chunks
+    fill(b, rb, rng, 55);
+    IdBitmap sparse;  // Array chunks only
+    std::set<std::uint32_t> rs;
+    for (std::uint32_t id = 5; id < 3 * 65536; id += 131) {
+        sparse.insert(id);
+        rs.insert(id);
+    }
+
+    for (auto [x, y, rx, ry] : {std::tuple{&a, &b, &ra, &rb}, std::tuple{&a, &sparse, &ra, &rs},
+                                std::tuple{&sparse, &b, &rs, &rb}}) {
+        std::vector<std::uint32_t> both, either, only;
+        std::set_intersection(rx->begin(), rx->end(), ry->begin(), ry->end(), std::back_inserter(both));
+        std::set_union(rx->begin(), rx->end(), ry->begin(), ry->end(), std::back_inserter(either));
+        std::set_difference(rx->begin(), rx->end(), ry->begin(), ry->end(), std::back_inserter(only));
+        ASSERT_TRUE(ids_of(*x & *y) == both);
+        ASSERT_TRUE(ids_of(*x | *y) == either);
+        ASSERT_TRUE(ids_of(*x - *y) == only);
+        ASSERT_EQ((*x & *y).count(), both.size());
+        ASSERT_EQ((*x | *y).count(), either.size());
+        ASSERT_EQ(IdBitmap::and_count(*x, *y), both.size());
+        ASSERT_EQ(IdBitmap::and_not_count(*x, *y), only.size());
+    }
+    ASSERT_TRUE((a | b) == (b | a));
+    ASSERT_TRUE(((a - b) | (a & b)) == a);
+    ASSERT_TRUE(!(a == b));
+    ASSERT_TRUE((a - a).empty());
+    return 0;
+}
+
+// A dense run is stored as bitsets: 8 KiB per 65536 IDs, not 2 bytes per ID.
+int test_dense_ids_compress() {
+    IdBitmap bitmap;
+    for (std::uint32_t id = 1; id <= 1000000; ++id) bitmap.insert(id);
+    ASSERT_EQ(bitmap.count(), 1000000u);
+    ASSERT_TRUE(bitmap.memory_bytes() < 16 * 8192 + 4096);
+    for (std::uint32_t id = 1; id <= 1000000; id += 2) bitmap.erase(id);
+    ASSERT_EQ(bitmap.count(), 500000u);
+    ASSERT_TRUE(bitmap.contains(2) && !bitmap.contains(3));
+    return 0;
+}
+
+// A bulk assignment builds the same set as inserting the IDs one by one.
+int test_assign_sorted_matches_inserts() {
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> percent(0, 99);
+    std::vector<std::int32_t> ids;
+    IdBitmap inserted;
+    for (std::int32_t id = 1; id < 4 * 65536; ++id) {
+        // Dense, sparse, empty and dense again by chunk.
+        int percent_set = id < 65536 ? 90 : id < 2 * 65536 ? 3 : id < 3 * 65536 ? 0 : 50;
+        if (percent(rng) >= percent_set) continue;
+        ids.push_back(id);
+        inserted.insert(static_cast<std::uint32_t>(id));
+    }
+    IdBitmap assigned;
+    assigned.insert(5);
+    assigned.assign_sorted(ids);
+    ASSERT_EQ(assigned.count(), ids.size());
+    ASSERT_TRUE(assigned == inserted);
+    ASSERT_TRUE(ids_of(assigned) == ids_of(inserted));
+    ASSERT_TRUE(assigned.memory_bytes() <= inserted.memory_bytes());
+    assigned.assign_sorted({});
+    ASSERT_TRUE(assigned.empty());
+    return 0;
+}
+
+// --- Main runner ---
+int main() {
+    int fails = 0;
+    fails += test_matches_a_set();
+    fails += test_set_algebra();
+    fails += test_dense_ids_compress();
+    fails += test_assign_sorted_matches_inserts();
+
+    if (fails == 0) {
+        std::cout << "[id_bitmap_unit_test] All tests passed\n";
+        return 0;
+    } else {
+        std::cout << "[id_bitmap_unit_test] " << fails << " tests failed\n";
+        return 1;
+    }
+}
@@ -0,0 +1,229 @@
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <unistd.h>
+
+#include "journal.hpp"
+#include "person_manager.hpp"
+#include "person.hpp"
+#include "snapshot.hpp"
+#include "task_manager.hpp"
+#include "task.hpp"
+
+// --- Tiny assert helpers ---
+#define ASSERT_TRUE(cond) do { \
+    if(!(cond)) { \
+        std::cerr << "[FAIL] " << __FILE__ << ":" << __LINE__ \
+                  << " ASSERT_TRUE(" << #cond << ")\n"; \
+        return 1; \
+    } \
+} while(0)
+
+#define ASSERT_EQ(a,b) do { \
+    if(!((a) == (b))) { \
+        std::cerr << "[FAIL] " << __FILE__ << ":" << __LINE__ \
+                  << " ASSERT_EQ(" << #a << "," << #b << ") got (" \
+                  << (a) << "," << (b) << ")\n"; \
+        return 1; \
+    } \
+} while(0)
+
+static const std::string journal_file = "journal_unit_test.journal";
+static const std::string snapshot_file = "journal_unit_test.snapshot";
+
+// Applies a few mutations the way the CLI does: change, then journal it.
+static void run_commands(TaskManager& tm, PersonManager& pm, Journal& journal) {
+    pm.add_person("alice");
+    journal.append(JournalOp::PersonAdd, "alice");
+    int root = tm.create_task("Root", "First task", pm.find_person_by_name("alice"));
+    journal.append(JournalOp::TaskAdd, root, "Root", "First task", "alice");
+    int child = tm.create_task("Child", "", nullptr);
+    journal.append(JournalOp::TaskAdd, child, "Child", "", "");
+    tm.make_child_task(root, child);
+    journal.append(JournalOp::TaskMakeChild, root, child);
+    tm.advance_task_status(child);
+    journal.append(JournalOp::TaskSetStatus, child, static_cast<int>(tm.get_task(child)->get_status()));
+    pm.change_name("alice", "alicia");
+    journal.append(JournalOp::PersonRename, "alice", "alicia");
+}
+
+// --- Tests ---
+int test_replay_restores_workspace() {
+    std::remove(journal_file.c_str());
+    {
+        TaskManager tm;
+        PersonManager pm;
+        Journal journal;
+        ASSERT_EQ(journal.open(journal_file, tm, pm), 1);
+        run_commands(tm, pm, journal);
+        ASSERT_EQ(journal.get_last_lsn(), 6u);
+    }
+
+    TaskManager tm;
+    PersonManager pm;
+    Journal journal;
+    ASSERT_EQ(journal.open(journal_file, tm, pm), 1);
+    ASSERT_EQ(journal.get_replayed_count(), 6u);
+    ASSERT_EQ(journal.get_last_lsn(), 6u);
+    ASSERT_TRUE(tm.get_task(1)->get_owner() == pm.find_person_by_name("alicia"));
+    ASSERT_EQ(tm.get_task(2)->get_parent()->get_id(), 1);
+    ASSERT_TRUE(tm.get_task(2)->get_status() == Task::Status::InProgress);
+    ASSERT_EQ(tm.get_next_id(), 3);
+
+    // New records continue the LSN sequence, and a move replays with its levels.
+    ASSERT_EQ(tm.move_task(2, 0), 1);
+    ASSERT_EQ(journal.append(JournalOp::TaskMove, 2, 0), 7u);
+    journal.close();
+    TaskManager tm2;
+    PersonManager pm2;
+    ASSERT_EQ(journal.open(journal_file, tm2, pm2), 1);
+    ASSERT_TRUE(tm2.get_task(2)->get_parent() == nullptr);
+    ASSERT_EQ(tm2.get_task(2)->get_level(), 1);
+    ASSERT_TRUE(tm2.get_task(1)->get_children_view().empty());
+
+    // A subtree delete replays as one record and unlinks the owner.
+    ASSERT_EQ(journal.append(JournalOp::TaskMakeChild, 1, 2), 8u);
+    ASSERT_EQ(journal.append(JournalOp::TaskDeleteSubtree, 1), 9u);
+    journal.close();
+    TaskManager tm3;
+    PersonManager pm3;
+    ASSERT_EQ(journal.open(journal_file, tm3, pm3), 1);
+    ASSERT_TRUE(tm3.get_task(1) == nullptr && tm3.get_task(2) == nullptr);
+    ASSERT_TRUE(pm3.find_person_by_name("alicia")->get_tasks_view().empty());
+    ASSERT_EQ(journal.append(JournalOp::TaskDelete, 2), 10u);
+    std::remove(journal_file.c_str());
+    return 0;
+}
+
+int test_snapshot_lsn_skips_folded_records() {
+    std::remove(journal_file.c_str());
+    {
+        TaskManager tm;
+        PersonManager pm;
+        Journal journal;
+        journal.set_fsync_policy(FsyncPolicy::Group, 1);
+        ASSERT_EQ(journal.open(journal_file, tm, pm), 1);
+        run_commands(tm, pm, journal);
+        // Checkpoint, then keep changing things.
+        ASSERT_EQ(save_snapshot(snapshot_file, tm, pm, journal.get_last_lsn()), 1);
+        ASSERT_EQ(journal.truncate(), 1);
+        tm.set_task_name(1, "Renamed root");
+        journal.append(JournalOp::TaskSetName, 1, "Renamed root");
+    }
+
+    TaskManager tm;
+    PersonManager pm;
+    std::uint64_t lsn = 0;
+    ASSERT_EQ(load_snapshot(snapshot_file, tm, pm, &lsn), 1);
+    ASSERT_EQ(lsn, 6u);
+    Journal journal;
+    ASSERT_EQ(journal.open(journal_file, tm, pm, lsn), 1);
+    ASSERT_EQ(journal.get_replayed_count(), 1u);
+    ASSERT_EQ(tm.get_task(1)->get_name(), "Renamed root");
+    ASSERT_EQ(journal.get_last_lsn(), 7u);
+    std::remove(journal_file.c_str());
+    std::remove(snapshot_file.c_str());
+    return 0;
+}
+
+int test_torn_tail_is_dropped() {
+    std::remove(journal_file.c_str());
+    std::uint64_t full_size = 0;
+    {
+        TaskManager tm;
+        PersonManager pm;
+        Journal journal;
+        journal.set_fsync_policy(FsyncPolicy::None);
+        ASSERT_EQ(journal.open(journal_file, tm, pm), 1);
+        run_commands(tm, pm, journal);
+        full_size = journal.get_size();
+    }
+    // Simulate a crash halfway through writing the last record.
+    ASSERT_EQ(::truncate(journal_file.c_str(), static_cast<off_t>(full_size - 5)), 0);
+
+    TaskManager tm;
+    PersonManager pm;
+    Journal journal;
+    ASSERT_EQ(journal.open(journal_file, tm, pm), 1);
+    ASSERT_EQ(journal.get_replayed_count(), 5u);
+    ASSERT_TRUE(pm.find_person_by_name("alice") != nullptr);  // Rename was lost
+    ASSERT_TRUE(journal.get_size() < full_size - 5);
+
+    // Appends after the repair are readable on the next start.
+    pm.add_person("bob");
+    ASSERT_EQ(journal.append(JournalOp::PersonAdd, "bob"), 6u);
+    journal.close();
+
+    TaskManager tm2;
+    PersonManager pm2;
+    ASSERT_EQ(journal.open(journal_file, tm2, pm2), 1);
+    ASSERT_EQ(journal.get_replayed_count(), 6u);
+    ASSERT_TRUE(pm2.find_person_by_name("bob") != nullptr);
+    journal.close();
+
+    // A file that is not a journal is left alone.
+    {
+        std::ofstream out(journal_file, std::ios::binary);
+        out << "definitely not a journal";
+    }
+    ASSERT_EQ(journal.open(journal_file, tm2, pm2), 0);
+    std::remove(journal_file.c_str());
+    return 0;
+}
+
+// Rotations while the group-commit thread is syncing: rotate() waits for
+// the sync before closing the old descriptor, and every record after the
+// last rotation replays.
+int test_rotation_during_group_commit() {
+    std::remove(journal_file.c_str());
+    std::remove((journal_file + ".old").c_str());
+    const int rounds = 50, per_round = 20;
+    {
+        TaskManager tm;
+        PersonManager pm;
+        Journal journal;
+        journal.set_fsync_policy(FsyncPolicy::Group, 1);
+        ASSERT_EQ(journal.open(journal_file, tm, pm), 1);
+        for (int round = 0; round < rounds; ++round) {
+            for (int i = 0; i < per_round; ++i) {
+                ASSERT_TRUE(journal.append(JournalOp::PersonAdd, "p" + std::to_string(round * per_round + i)) != 0);
+            }
+            ::usleep(500);
+            if (round + 1 < rounds) {
+                ASSERT_EQ(journal.rotate(), 1);
+                journal.drop_rotated();
+            }
+        }
+    }
+
+    TaskManager tm;
+    PersonManager pm;
+    Journal journal;
+    // As after loading the snapshot the last checkpoint wrote.
+    ASSERT_EQ(journal.open(journal_file, tm, pm, (rounds - 1) * per_round), 1);
+    ASSERT_EQ(journal.get_replayed_count(), static_cast<std::uint64_t>(per_round));
+    ASSERT_TRUE(pm.find_person_by_name("p" + std::to_string(rounds * per_round - 1)) != nullptr);
+    ASSERT_EQ(journal.get_last_lsn(), static_cast<std::uint64_t>(rounds * per_round));
+    journal.close();
+    std::remove(journal_file.c_str());
+    return 0;
+}
+
+// --- Main runner ---
+int main() {
+    int fails = 0;
+    fails += test_replay_restores_workspace();
+    fails += test_snapshot_lsn_skips_folded_records();
+    fails += test_torn_tail_is_dropped();
+    fails += test_rotation_during_group_commit();
+
+    if (fails == 0) {
+        std::cout << "[journal_unit_test] All tests passed\n";
+        return 0;
+    } else {
+        std::cout << "[journal_unit_test] " << fails << " tests failed\n";
+        return 1;
+    }
+}
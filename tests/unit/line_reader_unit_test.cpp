@@ -0,0 +1,78 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "line_reader.hpp"
+
+// --- Tiny assert helpers ---
+#define ASSERT_TRUE(cond) do { \
+    if(!(cond)) { \
+        std::cerr << "[FAIL] " << __FILE__ << ":" << __LINE__ \
+                  << " ASSERT_TRUE(" << #cond << ")\n"; \
+        return 1; \
+    } \
+} while(0)
+
+#define ASSERT_EQ(a,b) do { \
+    if(!((a) == (b))) { \
+        std::cerr << "[FAIL] " << __FILE__ << ":" << __LINE__ \
+                  << " ASSERT_EQ(" << #a << "," << #b << ") got (" \
+                  << (a) << "," << (b) << ")\n"; \
+        return 1; \
+    } \
+} while(0)
+
+// Feeds input through a pipe and collects every line the reader returns.
+static std::vector<std::string> read_lines(const std::string& input, size_t block_size) {
+    int fds[2];
+    if (::pipe(fds) != 0) return {};
+    ssize_t written = ::write(fds[1], input.data(), input.size());
+    ::close(fds[1]);
+    std::vector<std::string> lines;
+    if (written != static_cast<ssize_t>(input.size())) return lines;
+    LineReader reader(fds[0], block_size);
+    std::string_view line;
+    while (reader.next(line)) {
+        lines.emplace_back(line);
+    }
+    ::close(fds[0]);
+    return lines;
+}
+
+// --- Tests ---
+int test_lines_split_across_blocks() {
+    // A 4-byte block makes almost every line straddle a read, and the long
+    // line forces the buffer to grow.
+    auto lines = read_lines("task add -n a\r\n\nperson add a-much-longer-name-than-the-block\nlast", 4);
+    ASSERT_EQ(lines.size(), 4u);
+    ASSERT_EQ(lines[0], "task add -n a");
+    ASSERT_EQ(lines[1], "");
+    ASSERT_EQ(lines[2], "person add a-much-longer-name-than-the-block");
+    ASSERT_EQ(lines[3], "last");
+    return 0;
+}
+
+int test_empty_and_terminated_input() {
+    ASSERT_TRUE(read_lines("", 1 << 20).empty());
+    auto lines = read_lines("one\ntwo\n", 1 << 20);
+    ASSERT_EQ(lines.size(), 2u);
+    ASSERT_EQ(lines[1], "two");
+    return 0;
+}
+
+// --- Main runner ---
+int main() {
+    int fails = 0;
+    fails += test_lines_split_across_blocks();
+    fails += test_empty_and_terminated_input();
+
+    if (fails == 0) {
+        std::cout << "[line_reader_unit_test] All tests passed\n";
+        return 0;
+    } else {
+        std::cout << "[line_reader_unit_test] " << fails << " tests failed\n";
+        return 1;
+    }
+}
@@ -0,0 +1,107 @@
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+
+#include "output_sink.hpp"
+
+// --- Tiny assert helpers ---
+#define ASSERT_TRUE(cond) do { \
+    if(!(cond)) { \
+        std::cerr << "[FAIL] " << __FILE__ << ":" << __LINE__ \
+                  << " ASSERT_TRUE(" << #cond << ")\n"; \
+        return 1; \
+    } \
+} while(0)
+
+#define ASSERT_EQ(a,b) do { \
+    if(!((a) == (b))) { \
+        std::cerr << "[FAIL] " << __FILE__ << ":" << __LINE__ \
+                  << " ASSERT_EQ(" << #a << "," << #b << ") got (" \
+                  << (a) << "," << (b) << ")\n"; \
+        return 1; \
+    } \
+} while(0)
+
+// --- Tests ---
+int test_formats_like_ostream() {
+    std::ostringstream expected, actual;
+    {
+        OutputSink sink(actual);
+        sink << "Task ID: " << 42 << '\n' << -7 << ' ' << std::numeric_limits<std::uint64_t>::max()
+             << ' ' << std::numeric_limits<long long>::min() << ' ' << std::string("name") << '\n';
+        sink << 12.345678 << ' ' << 1e6 << ' ' << 0.0 << ' ' << 2.5e-7 << ' ' << 1234.5 << '\n';
+    }
+    expected << "Task ID: " << 42 << '\n' << -7 << ' ' << std::numeric_limits<std::uint64_t>::max()
+             << ' ' << std::numeric_limits<long long>::min() << ' ' << std::string("name") << '\n';
+    expected << 12.345678 << ' ' << 1e6 << ' ' << 0.0 << ' ' << 2.5e-7 << ' ' << 1234.5 << '\n';
+    ASSERT_EQ(actual.str(), expected.str());
+    return 0;
+}
+
+int test_holds_output_until_flush() {
+    std::ostringstream out;
+    OutputSink sink(out);
+    sink << "line one\n" << "line two\n";
+    ASSERT_TRUE(out.str().empty());
+    ASSERT_EQ(sink.pending(), 18u);
+    sink.flush();
+    ASSERT_EQ(out.str(), "line one\nline two\n");
+    ASSERT_EQ(sink.pending(), 0u);
+    return 0;
+}
+
+// A small buffer forces every path: filling up, numbers at the boundary and
+// strings larger than the whole buffer.
+int test_small_buffer_keeps_order() {
+    std::ostringstream out;
+    std::string expected;
+    {
+        OutputSink sink(out, 40);
+        std::string big(100, 'x');
+        for (int i = 0; i < 50; ++i) {
+            sink << "item " << i << ": ";
+            expected += "item " + std::to_string(i) + ": ";
+            if (i % 7 == 0) {
+                sink << big;
+                expected += big;
+            }
+            sink << '\n';
+            expected += '\n';
+        }
+    }
+    ASSERT_EQ(out.str(), expected);
+    return 0;
+}
+
+int test_indentation() {
+    std::ostringstream out;
+    OutputSink sink(out);
+    sink.indent(0);
+    sink.indent(1);
+    sink << '|';
+    sink.indent(3);
+    sink << '|';
+    sink.indent(200);
+    sink.flush();
+    ASSERT_EQ(out.str(), "|----|" + std::string(2 * 199, '-'));
+    return 0;
+}
+
+// --- Main runner ---
+int main() {
+    int fails = 0;
+    fails += test_formats_like_ostream();
+    fails += test_holds_output_until_flush();
+    fails += test_small_buffer_keeps_order();
+    fails += test_indentation();
+
+    if (fails == 0) {
+        std::cout << "[output_sink_unit_test] All tests passed\n";
+        return 0;
+    } else {
+        std::cout << "[output_sink_unit_test] " << fails << " tests failed\n";
+        return 1;
+    }
+}
@@ -1,7 +1,10 @@
+#include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <iostream>
 
+#include "output_sink.hpp"
 #include "person_manager.hpp"
 #include "person.hpp"
 #include "task.hpp"
@@ -137,13 +140,82 @@ int test_person_task_list_management() {
             ASSERT_TRUE(task->is_done());
         }
 
-        pm.delete_persons_all_tasks(person_name);
+        pm.unassign_persons_all_tasks(person_name);
         ASSERT_TRUE(p->get_tasks().empty());
     }
 #endif
     return 0;
 }
 
+// The name index must follow renames and deletes, and accept string_view keys.
+int test_name_index_tracks_rename_and_delete() {
+    PersonManager pm;
+    ASSERT_EQ(pm.add_person("Frank"), 1);
+    ASSERT_EQ(pm.add_person("Grace"), 1);
+    ASSERT_EQ(pm.add_person("Frank"), 0);  // duplicate
+
+    std::string_view token = "Frank";
+    Person* frank = pm.find_person_by_name(token);
+    ASSERT_TRUE(frank != nullptr);
+
+    ASSERT_EQ(pm.change_name("Frank", "Grace"), 0);  // name taken
+    ASSERT_EQ(pm.change_name("Frank", "Francis"), 1);
+    ASSERT_TRUE(pm.find_person_by_name("Frank") == nullptr);
+    ASSERT_TRUE(pm.find_person_by_name("Francis") == frank);
+    ASSERT_EQ(frank->get_name(), "Francis");
+
+    ASSERT_EQ(pm.delete_person("Francis"), 1);
+    ASSERT_TRUE(pm.find_person_by_name("Francis") == nullptr);
+    ASSERT_EQ(pm.delete_person("Francis"), 0);
+
+    // A deleted name can be reused by a new person.
+    ASSERT_EQ(pm.add_person("Francis"), 1);
+    ASSERT_TRUE(pm.find_person_by_name("Francis") != nullptr);
+    ASSERT_TRUE(pm.find_person_by_name("Grace") != nullptr);
+    return 0;
+}
+
+// Deleting a person unassigns their tasks instead of leaving them dangling.
+int test_delete_person_unassigns_tasks() {
+    PersonManager pm;
+    pm.add_person("Heidi");
+    Task t1(1, "Task 1", "Description 1");
+    Task t2(2, "Task 2", "Description 2");
+    ASSERT_EQ(pm.assign_task("Heidi", &t1), 1);
+    ASSERT_EQ(pm.assign_task("Heidi", &t2), 1);
+    ASSERT_TRUE(t1.get_owner() == pm.find_person_by_name("Heidi"));
+
+    ASSERT_EQ(pm.delete_person("Heidi"), 1);
+    ASSERT_TRUE(t1.get_owner() == nullptr);
+    ASSERT_TRUE(t2.get_owner() == nullptr);
+    return 0;
+}
+
+// Nested, a person's tasks print under their parent when the person owns
+// that too, and a task under someone else's starts a tree of its own.
+int test_nested_task_listing() {
+    PersonManager pm;
+    pm.add_person("Heidi");
+    pm.add_person("Ivan");
+    Task t1(1, "Task 1", ""), t2(2, "Task 2", ""), t3(3, "Task 3", ""), t4(4, "Task 4", ""), t5(5, "Task 5", "");
+    for (auto [parent, child] : {std::pair{&t1, &t2}, std::pair{&t2, &t3}, std::pair{&t3, &t4}}) {
+        parent->add_child(child);
+        child->set_parent(parent);
+    }
+    for (Task* task : {&t1, &t2, &t4, &t5}) pm.assign_task("Heidi", task);
+    pm.assign_task("Ivan", &t3);
+
+    std::ostringstream captured;
+    std::streambuf* saved = std::cout.rdbuf(captured.rdbuf());
+    PrintOptions options;
+    options.nested = true;
+    pm.print_persons_tasks("Heidi", options);
+    get_output().flush();
+    std::cout.rdbuf(saved);
+    ASSERT_EQ(captured.str(), " - 1: Task 1\n-- - 2: Task 2\n - 4: Task 4\n - 5: Task 5\n");
+    return 0;
+}
+
 // --- Main runner ---
 int main() {
     int fails = 0;
@@ -151,6 +223,9 @@ int main() {
     fails += test_remove_person();
     fails += test_assign_task_via_manager();
     fails += test_person_task_list_management();
+    fails += test_name_index_tracks_rename_and_delete();
+    fails += test_delete_person_unassigns_tasks();
+    fails += test_nested_task_listing();
 
     if (fails == 0) {
         std::cout << "[person_manager_unit_test] All tests passed\n";
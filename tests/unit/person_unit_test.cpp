@@ -76,10 +76,10 @@ int test_assigns_and_removes() {
             if constexpr (HasRemoveAllTasks<P>) {
                 alice.remove_all_tasks();
                 ASSERT_EQ(alice.get_tasks().size(), 0u);
-            } else {
-                delete t1;
-                delete t2;
             }
+            // Removing only unassigns; the tasks are still ours to free.
+            delete t1;
+            delete t2;
         }
     }
 #endif
@@ -93,9 +93,9 @@ int test_reports_number_of_tasks() {
 
     if constexpr (PersonLike<P>) {
         P bob("Bob");
+        T t(1, "Task 1", "Description 1");
         if constexpr (HasAssignTask<P>) {
-            T* t = new T(1, "Task 1", "Description 1");
-            bob.assign_task(t);
+            bob.assign_task(&t);
         }
         if constexpr (HasReturnNumberOfTasks<P>) {
             int n = bob.return_number_of_tasks();
@@ -151,12 +151,52 @@ int tests_set_all_tasks_to_done() {
     return 0;
 }
 
+// Swap-removal keeps each task's position in its owner's list consistent,
+// and reassigning moves a task between owners in one step.
+int test_owner_links_stay_consistent() {
+    Person alice("Alice");
+    Person bob("Bob");
+    Task t1(1, "Task 1", "Description 1");
+    Task t2(2, "Task 2", "Description 2");
+    Task t3(3, "Task 3", "Description 3");
+    alice.assign_task(&t1);
+    alice.assign_task(&t2);
+    alice.assign_task(&t3);
+    ASSERT_TRUE(t2.get_owner() == &alice);
+
+    alice.remove_task(&t1);  // t3 moves into t1's position
+    ASSERT_TRUE(t1.get_owner() == nullptr);
+    ASSERT_EQ(alice.get_tasks().size(), 2u);
+
+    bob.assign_task(&t3);
+    ASSERT_TRUE(t3.get_owner() == &bob);
+    ASSERT_EQ(alice.get_tasks().size(), 1u);
+    ASSERT_TRUE(alice.get_tasks()[0] == &t2);
+    ASSERT_EQ(bob.get_tasks().size(), 1u);
+
+    alice.remove_task(&t3);  // not Alice's task any more: no-op
+    ASSERT_TRUE(t3.get_owner() == &bob);
+
+    {
+        Task temporary(4, "Task 4", "Description 4", &bob);
+        ASSERT_EQ(bob.get_tasks().size(), 2u);
+    }
+    // A destroyed task drops out of its owner's list.
+    ASSERT_EQ(bob.get_tasks().size(), 1u);
+    ASSERT_TRUE(bob.get_tasks()[0] == &t3);
+
+    t2.unown();
+    ASSERT_TRUE(alice.get_tasks().empty());
+    return 0;
+}
+
 // --- Main runner ---
 int main() {
     int fails = 0;
     fails += test_assigns_and_removes();
     fails += test_reports_number_of_tasks();
     fails += tests_set_and_get_name();
+    fails += test_owner_links_stay_consistent();
 
     if (fails == 0) {
         std::cout << "[person_unit_test] All tests passed\n";
@@ -0,0 +1,119 @@
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <streambuf>
+#include <string>
+
+#include "output_sink.hpp"
+#include "person_manager.hpp"
+#include "person.hpp"
+#include "task_manager.hpp"
+#include "task.hpp"
+#include "print_options.hpp"
+
+// --- Tiny assert helpers ---
+#define ASSERT_TRUE(cond) do { \
+    if(!(cond)) { \
+        std::cerr << "[FAIL] " << __FILE__ << ":" << __LINE__ \
+                  << " ASSERT_TRUE(" << #cond << ")\n"; \
+        return 1; \
+    } \
+} while(0)
+
+#define ASSERT_EQ(a,b) do { \
+    if(!((a) == (b))) { \
+        std::cerr << "[FAIL] " << __FILE__ << ":" << __LINE__ \
+                  << " ASSERT_EQ(" << #a << "," << #b << ") got (" \
+                  << (a) << "," << (b) << ")\n"; \
+        return 1; \
+    } \
+} while(0)
+
+// --- Allocation counting ---
+// Every global operator new in this binary goes through here.
+static long allocation_count = 0;
+
+void* operator new(std::size_t size) {
+    ++allocation_count;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+// Swallows everything written to it so printing cost is just formatting.
+struct NullBuffer : std::streambuf {
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+// The output sink is created, and its buffer allocated, before counting
+// starts; flushing it is part of what is measured.
+template <typename Fn>
+static long allocations_during(Fn&& fn) {
+    NullBuffer null_buffer;
+    std::streambuf* saved = std::cout.rdbuf(&null_buffer);
+    OutputSink& output = get_output();
+    long before = allocation_count;
+    fn();
+    output.flush();
+    long after = allocation_count;
+    std::cout.rdbuf(saved);
+    return after - before;
+}
+
+// Names and descriptions are long enough to defeat the small-string
+// optimization, so any copy made while printing would show up here.
+static void populate(TaskManager& tm, PersonManager& pm, int count) {
+    pm.add_person("A person with a rather long name");
+    Person* person = pm.find_person_by_name("A person with a rather long name");
+    int parent_id = 0;
+    for (int i = 0; i < count; ++i) {
+        int id = tm.create_task("Task with a name that does not fit in SSO " + std::to_string(i),
+                                "Description that also does not fit in SSO " + std::to_string(i));
+        tm.assign_task(id, person);
+        pm.assign_task(person->get_name_view(), tm.get_task(id));
+        if (i % 4 == 0) {
+            parent_id = id;
+        } else {
+            tm.make_child_task(parent_id, id);
+        }
+    }
+}
+
+// --- Tests ---
+int test_list_commands_do_not_allocate_per_task() {
+    TaskManager tm;
+    PersonManager pm;
+    populate(tm, pm, 200);
+
+    PrintOptions options;
+    options.verbose = true;
+    options.nested = true;
+
+    ASSERT_EQ(allocations_during([&] { tm.print_all_tasks(options); }), 0);
+    ASSERT_EQ(allocations_during([&] { tm.print_task(1, options); }), 0);
+    ASSERT_EQ(allocations_during([&] { tm.print_all_task_owners(options); }), 0);
+    ASSERT_EQ(allocations_during([&] { pm.print_all_people(options); }), 0);
+    ASSERT_EQ(allocations_during([&] {
+        pm.print_persons_tasks("A person with a rather long name", options);
+    }), 0);
+    ASSERT_EQ(allocations_during([&] {
+        pm.print_all_peoples_task_counts(true, tm.owner_sets(), tm.child_set());
+    }), 0);
+    return 0;
+}
+
+// --- Main runner ---
+int main() {
+    int fails = 0;
+    fails += test_list_commands_do_not_allocate_per_task();
+
+    if (fails == 0) {
+        std::cout << "[print_alloc_unit_test] All tests passed\n";
+        return 0;
+    } else {
+        std::cout << "[print_alloc_unit_test] " << fails << " tests failed\n";
+        return 1;
+    }
+}
@@ -0,0 +1,127 @@
+#include <array>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "output_sink.hpp"
+#include "person.hpp"
+#include "record_writer.hpp"
+#include "task.hpp"
+
+// --- Tiny assert helpers ---
+#define ASSERT_TRUE(cond) do { \
+    if(!(cond)) { \
+        std::cerr << "[FAIL] " << __FILE__ << ":" << __LINE__ \
+                  << " ASSERT_TRUE(" << #cond << ")\n"; \
+        return 1; \
+    } \
+} while(0)
+
+#define ASSERT_EQ(a,b) do { \
+    if(!((a) == (b))) { \
+        std::cerr << "[FAIL] " << __FILE__ << ":" << __LINE__ \
+                  << " ASSERT_EQ(" << #a << "," << #b << ") got (" \
+                  << (a) << "," << (b) << ")\n"; \
+        return 1; \
+    } \
+} while(0)
+
+static constexpr std::array<std::string_view, 3> columns = {"id", "text", "extra"};
+
+// Writes two records, the second with every character that needs escaping
+// in one format or another.
+static std::string write_sample(OutputFormat format) {
+    std::ostringstream stream;
+    {
+        OutputSink sink(stream);
+        RecordWriter writer(sink, format, columns);
+        writer.field(std::int64_t{1});
+        writer.field("plain");
+        writer.null_field();
+        writer.end_record();
+        writer.field(std::int64_t{-2});
+        writer.field("a,b \"q\"\tc\\d\ne");
+        writer.field(std::string_view("\x01", 1));
+        writer.end_record();
+    }
+    return stream.str();
+}
+
+// --- Tests ---
+int test_jsonl() {
+    ASSERT_EQ(write_sample(OutputFormat::Jsonl),
+              "{\"id\":1,\"text\":\"plain\",\"extra\":null}\n"
+              "{\"id\":-2,\"text\":\"a,b \\\"q\\\"\\tc\\\\d\\ne\",\"extra\":\"\\u0001\"}\n");
+    return 0;
+}
+
+int test_csv() {
+    ASSERT_EQ(write_sample(OutputFormat::Csv),
+              "id,text,extra\n"
+              "1,plain,\n"
+              "-2,\"a,b \"\"q\"\"\tc\\d\ne\",\x01\n");
+    return 0;
+}
+
+int test_tsv() {
+    ASSERT_EQ(write_sample(OutputFormat::Tsv),
+              "id\ttext\textra\n"
+              "1\tplain\t\n"
+              "-2\ta,b \"q\"\\tc\\\\d\\ne\t\x01\n");
+    return 0;
+}
+
+int test_parse_output_format() {
+    OutputFormat format = OutputFormat::Text;
+    ASSERT_TRUE(parse_output_format("csv", format));
+    ASSERT_TRUE(format == OutputFormat::Csv);
+    ASSERT_TRUE(parse_output_format("jsonl", format));
+    ASSERT_TRUE(format == OutputFormat::Jsonl);
+    ASSERT_TRUE(!parse_output_format("json", format));
+    ASSERT_TRUE(!parse_output_format("", format));
+    ASSERT_TRUE(format == OutputFormat::Jsonl);
+    return 0;
+}
+
+int test_task_and_person_records() {
+    Person alice("alice", 3);
+    Task parent(7, "Parent", "");
+    Task child(8, "Child, with comma", "Line one\nline two", &alice, Task::Status::Blocked);
+    child.set_parent(&parent);
+
+    std::ostringstream stream;
+    {
+        OutputSink sink(stream);
+        RecordWriter tasks(sink, OutputFormat::Csv, task_columns);
+        write_task_record(tasks, parent);
+        write_task_record(tasks, child);
+        RecordWriter people(sink, OutputFormat::Jsonl, person_columns);
+        write_person_record(people, alice);
+    }
+    ASSERT_EQ(stream.str(),
+              "id,name,description,status,owner,parent,level\n"
+              "7,Parent,,Todo,,,1\n"
+              "8,\"Child, with comma\",\"Line one\nline two\",Blocked,alice,7,2\n"
+              "{\"id\":3,\"name\":\"alice\",\"tasks\":1}\n");
+    child.unown();
+    return 0;
+}
+
+// --- Main runner ---
+int main() {
+    int fails = 0;
+    fails += test_jsonl();
+    fails += test_csv();
+    fails += test_tsv();
+    fails += test_parse_output_format();
+    fails += test_task_and_person_records();
+
+    if (fails == 0) {
+        std::cout << "[record_writer_unit_test] All tests passed\n";
+        return 0;
+    } else {
+        std::cout << "[record_writer_unit_test] " << fails << " tests failed\n";
+        return 1;
+    }
+}
@@ -0,0 +1,109 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "slab_pool.hpp"
+
+// --- Tiny assert helpers ---
+#define ASSERT_TRUE(cond) do { \
+    if(!(cond)) { \
+        std::cerr << "[FAIL] " << __FILE__ << ":" << __LINE__ \
+                  << " ASSERT_TRUE(" << #cond << ")\n"; \
+        return 1; \
+    } \
+} while(0)
+
+#define ASSERT_EQ(a,b) do { \
+    if(!((a) == (b))) { \
+        std::cerr << "[FAIL] " << __FILE__ << ":" << __LINE__ \
+                  << " ASSERT_EQ(" << #a << "," << #b << ") got (" \
+                  << (a) << "," << (b) << ")\n"; \
+        return 1; \
+    } \
+} while(0)
+
+// Counts live instances so we can check that the pool runs destructors.
+struct Tracked {
+    static int alive;
+    std::string payload;
+    explicit Tracked(std::string payload) : payload(std::move(payload)) { ++alive; }
+    ~Tracked() { --alive; }
+};
+int Tracked::alive = 0;
+
+// Objects keep their address while the pool grows past several chunks.
+int test_addresses_are_stable_across_chunks() {
+    SlabPool<Tracked, 4> pool;
+    std::vector<Tracked*> objects;
+    for (int i = 0; i < 10; ++i) {
+        objects.push_back(pool.create("object " + std::to_string(i)));
+    }
+    ASSERT_EQ(pool.size(), 10u);
+    ASSERT_EQ(pool.chunk_count(), 3u);
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_EQ(objects[i]->payload, "object " + std::to_string(i));
+    }
+    return 0;
+}
+
+// A destroyed slot is handed out again before the pool grows.
+int test_destroyed_slots_are_recycled() {
+    SlabPool<Tracked, 4> pool;
+    Tracked* a = pool.create("a");
+    Tracked* b = pool.create("b");
+    pool.destroy(a);
+    ASSERT_EQ(Tracked::alive, 1);
+    ASSERT_EQ(pool.size(), 1u);
+
+    Tracked* c = pool.create("c");
+    ASSERT_TRUE(c == a);
+    ASSERT_EQ(c->payload, "c");
+    ASSERT_EQ(b->payload, "b");
+    ASSERT_EQ(pool.chunk_count(), 1u);
+
+    pool.destroy(b);
+    pool.destroy(c);
+    ASSERT_EQ(Tracked::alive, 0);
+    return 0;
+}
+
+// clear() destroys exactly the live objects, including around freed holes.
+int test_clear_destroys_only_live_objects() {
+    {
+        SlabPool<Tracked, 4> pool;
+        std::vector<Tracked*> objects;
+        for (int i = 0; i < 9; ++i) {
+            objects.push_back(pool.create(std::to_string(i)));
+        }
+        pool.destroy(objects[1]);
+        pool.destroy(objects[6]);
+        ASSERT_EQ(Tracked::alive, 7);
+
+        pool.clear();
+        ASSERT_EQ(Tracked::alive, 0);
+        ASSERT_EQ(pool.size(), 0u);
+        ASSERT_EQ(pool.chunk_count(), 0u);
+
+        // The pool is reusable after clear(), and its destructor cleans up too.
+        pool.create("again");
+        ASSERT_EQ(Tracked::alive, 1);
+    }
+    ASSERT_EQ(Tracked::alive, 0);
+    return 0;
+}
+
+// --- Main runner ---
+int main() {
+    int fails = 0;
+    fails += test_addresses_are_stable_across_chunks();
+    fails += test_destroyed_slots_are_recycled();
+    fails += test_clear_destroys_only_live_objects();
+
+    if (fails == 0) {
+        std::cout << "[slab_pool_unit_test] All tests passed\n";
+        return 0;
+    } else {
+        std::cout << "[slab_pool_unit_test] " << fails << " tests failed\n";
+        return 1;
+    }
+}
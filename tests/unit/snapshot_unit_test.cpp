@@ -0,0 +1,214 @@
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "person_manager.hpp"
+#include "person.hpp"
+#include "snapshot.hpp"
+#include "task_manager.hpp"
+#include "task.hpp"
+
+// --- Tiny assert helpers ---
+#define ASSERT_TRUE(cond) do { \
+    if(!(cond)) { \
+        std::cerr << "[FAIL] " << __FILE__ << ":" << __LINE__ \
+                  << " ASSERT_TRUE(" << #cond << ")\n"; \
+        return 1; \
+    } \
+} while(0)
+
+#define ASSERT_EQ(a,b) do { \
+    if(!((a) == (b))) { \
+        std::cerr << "[FAIL] " << __FILE__ << ":" << __LINE__ \
+                  << " ASSERT_EQ(" << #a << "," << #b << ") got (" \
+                  << (a) << "," << (b) << ")\n"; \
+        return 1; \
+    } \
+} while(0)
+
+static const std::string snapshot_file = "snapshot_unit_test.snapshot";
+
+// Builds a small workspace with a deleted task, owners and a two-level hierarchy:
+//   1 "Root" (alice) -> 4 "Second child", 3 "First child" (bob) -> 5 "Grandchild"
+static void populate(TaskManager& tm, PersonManager& pm) {
+    pm.add_person("alice");
+    pm.add_person("bob");
+    Person* alice = pm.find_person_by_name("alice");
+    Person* bob = pm.find_person_by_name("bob");
+    tm.create_task("Root", "The root task", alice);
+    tm.create_task("Deleted", "Gone before the snapshot");
+    tm.create_task("First child", "", bob);
+    tm.create_task("Second child", "Has a \"quoted\" description");
+    tm.create_task("Grandchild", "Deepest task");
+    tm.delete_task(2);
+    tm.make_child_task(1, 4);
+    tm.make_child_task(1, 3);
+    tm.make_child_task(3, 5);
+    tm.advance_task_status(3);
+    tm.mark_task_as_done(5);
+}
+
+static void write_image(const std::vector<char>& image) {
+    std::ofstream out(snapshot_file, std::ios::binary);
+    out.write(image.data(), static_cast<std::streamsize>(image.size()));
+}
+
+// Rewrites a field of the image and recomputes the checksum, the way a
+// crafted file would, so only the record checks stand in the way.
+template <typename T>
+static void patch(std::vector<char>& image, std::size_t offset, T value) {
+    std::memcpy(image.data() + offset, &value, sizeof(value));
+    SnapshotHeader header;
+    std::memcpy(&header, image.data(), sizeof(header));
+    header.checksum = snapshot_checksum(image.data() + sizeof(header), image.size() - sizeof(header));
+    std::memcpy(image.data(), &header, sizeof(header));
+}
+
+// --- Tests ---
+int test_round_trip_preserves_workspace() {
+    {
+        TaskManager tm;
+        PersonManager pm;
+        populate(tm, pm);
+        ASSERT_EQ(save_snapshot(snapshot_file, tm, pm), 1);
+    }
+
+    TaskManager tm;
+    PersonManager pm;
+    ASSERT_EQ(load_snapshot(snapshot_file, tm, pm), 1);
+
+    ASSERT_TRUE(tm.get_task(2) == nullptr);
+    ASSERT_EQ(tm.get_task(1)->get_name(), "Root");
+    ASSERT_EQ(tm.get_task(1)->get_description(), "The root task");
+    ASSERT_EQ(tm.get_task(4)->get_description(), "Has a \"quoted\" description");
+    ASSERT_TRUE(tm.get_task(1)->get_owner() == pm.find_person_by_name("alice"));
+    ASSERT_TRUE(tm.get_task(3)->get_owner() == pm.find_person_by_name("bob"));
+    ASSERT_TRUE(tm.get_task(4)->get_owner() == nullptr);
+    ASSERT_EQ(pm.find_person_by_name("alice")->get_tasks().size(), 1u);
+
+    // Sibling order and levels survive the round trip.
+    auto children = tm.get_task(1)->get_children_view();
+    ASSERT_EQ(children.size(), 2u);
+    ASSERT_EQ(children[0]->get_id(), 4);
+    ASSERT_EQ(children[1]->get_id(), 3);
+    ASSERT_EQ(tm.get_task(5)->get_parent()->get_id(), 3);
+    ASSERT_EQ(tm.get_task(5)->get_level(), 3);
+
+    ASSERT_TRUE(tm.get_task(3)->get_status() == Task::Status::InProgress);
+    ASSERT_TRUE(tm.get_task(5)->is_done());
+
+    // Loaded text points into the file; editing one field copies both.
+    tm.get_task(4)->set_name("Renamed");
+    ASSERT_EQ(tm.get_task(4)->get_name(), "Renamed");
+    ASSERT_EQ(tm.get_task(4)->get_description(), "Has a \"quoted\" description");
+    tm.get_task(1)->set_description("");
+    ASSERT_EQ(tm.get_task(1)->get_name(), "Root");
+    ASSERT_EQ(tm.get_task(1)->get_description(), "");
+
+    // The ID counter is restored too, so deleted IDs stay retired.
+    ASSERT_EQ(tm.create_task("After load", ""), 6);
+    std::remove(snapshot_file.c_str());
+    return 0;
+}
+
+int test_corrupted_snapshot_is_rejected() {
+    TaskManager tm;
+    PersonManager pm;
+    populate(tm, pm);
+    std::vector<char> image = encode_snapshot(tm, pm);
+
+    // Flip one byte in the string heap: the checksum must catch it and the
+    // current workspace must be left untouched.
+    image[image.size() - 3] ^= 0x20;
+    {
+        std::ofstream out(snapshot_file, std::ios::binary);
+        out.write(image.data(), static_cast<std::streamsize>(image.size()));
+    }
+    ASSERT_EQ(load_snapshot(snapshot_file, tm, pm), 0);
+    ASSERT_EQ(tm.get_task(1)->get_name(), "Root");
+
+    // Truncated file
+    {
+        std::ofstream out(snapshot_file, std::ios::binary);
+        out.write(image.data(), 20);
+    }
+    ASSERT_EQ(load_snapshot(snapshot_file, tm, pm), 0);
+
+    std::remove(snapshot_file.c_str());
+    ASSERT_EQ(load_snapshot(snapshot_file, tm, pm), 0);  // missing file
+    ASSERT_TRUE(tm.get_task(5) != nullptr);
+    return 0;
+}
+
+// Well-formed files that still describe an impossible workspace are
+// refused before anything is cleared.
+int test_crafted_snapshot_is_rejected() {
+    TaskManager tm;
+    PersonManager pm;
+    populate(tm, pm);
+    const std::vector<char> image = encode_snapshot(tm, pm);
+    const std::size_t people = sizeof(SnapshotHeader);
+    const std::size_t tasks = people + 2 * sizeof(PersonRecord);
+    auto rejected = [&](std::vector<char> crafted) {
+        write_image(crafted);
+        return load_snapshot(snapshot_file, tm, pm) == 0 && tm.get_task(1) && tm.get_task(1)->get_name() == "Root"
+            && pm.find_person_by_name("bob");
+    };
+
+    std::vector<char> crafted = image;  // The second task takes the first one's ID
+    std::uint32_t first_id;
+    std::memcpy(&first_id, image.data() + tasks + offsetof(TaskRecord, id), sizeof(first_id));
+    patch(crafted, tasks + sizeof(TaskRecord) + offsetof(TaskRecord, id), first_id);
+    ASSERT_TRUE(rejected(crafted));
+
+    crafted = image;  // Both people named like the first
+    std::uint64_t first_name;
+    std::memcpy(&first_name, image.data() + people + offsetof(PersonRecord, name_offset), sizeof(first_name));
+    patch(crafted, people + sizeof(PersonRecord) + offsetof(PersonRecord, name_offset), first_name);
+    std::uint32_t first_length;
+    std::memcpy(&first_length, image.data() + people + offsetof(PersonRecord, name_length), sizeof(first_length));
+    patch(crafted, people + sizeof(PersonRecord) + offsetof(PersonRecord, name_length), first_length);
+    ASSERT_TRUE(rejected(crafted));
+
+    crafted = image;  // An offset that wraps the heap bound around
+    patch(crafted, tasks + offsetof(TaskRecord, name_offset), ~std::uint64_t{0});
+    ASSERT_TRUE(rejected(crafted));
+    crafted = image;
+    patch(crafted, people + offsetof(PersonRecord, name_offset), ~std::uint64_t{0} - 1);
+    ASSERT_TRUE(rejected(crafted));
+
+    crafted = image;  // A heap size that wraps the total size around
+    patch(crafted, offsetof(SnapshotHeader, string_heap_size), ~std::uint64_t{0} - 100);
+    ASSERT_TRUE(rejected(crafted));
+
+    crafted = image;  // The last task's parent is a sibling of its own parent, no longer open
+    patch(crafted, tasks + 3 * sizeof(TaskRecord) + offsetof(TaskRecord, parent), std::uint32_t{1});
+    ASSERT_TRUE(rejected(crafted));
+
+    crafted = image;  // An ID counter past int
+    patch(crafted, offsetof(SnapshotHeader, next_task_id), std::uint32_t{0x80000000});
+    ASSERT_TRUE(rejected(crafted));
+
+    std::remove(snapshot_file.c_str());
+    return 0;
+}
+
+// --- Main runner ---
+int main() {
+    int fails = 0;
+    fails += test_round_trip_preserves_workspace();
+    fails += test_corrupted_snapshot_is_rejected();
+    fails += test_crafted_snapshot_is_rejected();
+
+    if (fails == 0) {
+        std::cout << "[snapshot_unit_test] All tests passed\n";
+        return 0;
+    } else {
+        std::cout << "[snapshot_unit_test] " << fails << " tests failed\n";
+        return 1;
+    }
+}
@@ -1,7 +1,12 @@
+#include <algorithm>
 #include <iostream>
+#include <sstream>
+#include <span>
 #include <string>
+#include <vector>
 
 // Project headers
+#include "output_sink.hpp"
 #include "task_manager.hpp"
 #include "task.hpp"
 #include "print_options.hpp"
@@ -94,6 +99,285 @@ static int test_make_child_task_fails_when_ids_missing() {
     return 0;
 }
 
+// A task cannot go under itself or its own descendants, nor take a second parent.
+static int test_make_child_task_rejects_cycles() {
+    TaskManager tm;
+    int a = tm.create_task("A", "");
+    int b = tm.create_task("B", "");
+    int c = tm.create_task("C", "");
+    int d = tm.create_task("D", "");
+    ASSERT_EQ(tm.make_child_task(a, b), 1);
+    ASSERT_EQ(tm.make_child_task(b, c), 1);
+    ASSERT_EQ(tm.make_child_task(a, a), 0);
+    ASSERT_EQ(tm.make_child_task(c, a), 0);  // a -> b -> c -> a
+    ASSERT_EQ(tm.make_child_task(b, a), 0);
+    ASSERT_EQ(tm.make_child_task(d, c), 0);  // c is already under b
+    ASSERT_TRUE(tm.get_task(a)->get_parent() == nullptr);
+    ASSERT_EQ(tm.get_task(b)->get_children_view().size(), 1u);
+
+    ASSERT_TRUE(tm.is_descendant(c, a) && tm.is_descendant(b, a));
+    ASSERT_TRUE(!tm.is_descendant(a, c) && !tm.is_descendant(a, a) && !tm.is_descendant(d, a));
+    ASSERT_EQ(tm.count_descendants(a), 2);
+    std::vector<int> under;
+    tm.for_each_descendant(a, [&](const Task* task, int depth) { under.push_back(task->get_id() * 10 + depth); });
+    ASSERT_TRUE(under == (std::vector<int>{b * 10 + 1, c * 10 + 2}));
+
+    tm.delete_task(c);
+    ASSERT_EQ(tm.count_descendants(a), 1);
+    ASSERT_EQ(tm.make_child_task(c, d), 0);
+    return 0;
+}
+
+// Moving a task carries its subtree along and renumbers the levels.
+static int test_move_task_renumbers_subtree() {
+    TaskManager tm;
+    int a = tm.create_task("A", "");
+    int b = tm.create_task("B", "");
+    int c = tm.create_task("C", "");
+    int d = tm.create_task("D", "");
+    int e = tm.create_task("E", "");
+    tm.make_child_task(a, b);
+    tm.make_child_task(b, c);
+    tm.make_child_task(a, d);
+    tm.make_child_task(a, e);
+
+    ASSERT_EQ(tm.move_task(b, d), 1);
+    ASSERT_TRUE(tm.get_task(b)->get_parent() == tm.get_task(d));
+    ASSERT_EQ(tm.get_task(b)->get_level(), 3);
+    ASSERT_EQ(tm.get_task(c)->get_level(), 4);
+    ASSERT_TRUE(tm.is_descendant(c, d));
+    // b's slot in a's child list went to e, the last child.
+    auto children = tm.get_task(a)->get_children_view();
+    ASSERT_TRUE(std::vector<Task*>(children.begin(), children.end()) == (std::vector<Task*>{tm.get_task(e), tm.get_task(d)}));
+
+    ASSERT_EQ(tm.move_task(d, c), 0);  // c is under d
+    ASSERT_EQ(tm.move_task(d, d), 0);
+    ASSERT_EQ(tm.move_task(d, 99), 0);
+    ASSERT_EQ(tm.move_task(b, b), 0);
+
+    ASSERT_EQ(tm.move_task(b, 0), 1);
+    ASSERT_TRUE(tm.get_task(b)->get_parent() == nullptr);
+    ASSERT_TRUE(tm.get_task(d)->get_children_view().empty());
+    ASSERT_EQ(tm.get_task(b)->get_level(), 1);
+    ASSERT_EQ(tm.get_task(c)->get_level(), 2);
+    ASSERT_TRUE(!tm.child_set().contains(b));
+    ASSERT_EQ(tm.move_task(e, d), 1);
+    ASSERT_EQ(tm.get_task(e)->get_level(), 3);
+    return 0;
+}
+
+// Deleting a task alone moves its children up into its place.
+static int test_delete_task_promotes_children() {
+    TaskManager tm;
+    int a = tm.create_task("A", "");
+    int b = tm.create_task("B", "");
+    int c = tm.create_task("C", "");
+    int d = tm.create_task("D", "");
+    int e = tm.create_task("E", "");
+    tm.make_child_task(a, b);
+    tm.make_child_task(b, c);
+    tm.make_child_task(c, d);
+    tm.make_child_task(b, e);
+    tm.mark_task_as_done(d);
+    ASSERT_EQ(tm.subtree_status_counts(a)[static_cast<int>(Task::Status::Done)], 1);
+
+    ASSERT_EQ(tm.delete_task(b), 1);
+    auto children = tm.get_task(a)->get_children_view();
+    ASSERT_TRUE(std::vector<Task*>(children.begin(), children.end()) == (std::vector<Task*>{tm.get_task(c), tm.get_task(e)}));
+    ASSERT_TRUE(tm.get_task(c)->get_parent() == tm.get_task(a));
+    ASSERT_EQ(tm.get_task(c)->get_level(), 2);
+    ASSERT_EQ(tm.get_task(d)->get_level(), 3);
+    ASSERT_TRUE(tm.is_descendant(d, a));
+    ASSERT_EQ(tm.count_descendants(a), 3);
+    ASSERT_EQ(tm.subtree_status_counts(a)[static_cast<int>(Task::Status::Todo)], 2);
+    ASSERT_EQ(tm.subtree_status_counts(a)[static_cast<int>(Task::Status::Done)], 1);
+
+    // At the top level there is no parent to take them.
+    ASSERT_EQ(tm.delete_task(a), 1);
+    ASSERT_TRUE(tm.get_task(c)->get_parent() == nullptr);
+    ASSERT_EQ(tm.get_task(c)->get_level(), 1);
+    ASSERT_EQ(tm.get_task(d)->get_level(), 2);
+    ASSERT_TRUE(!tm.child_set().contains(c));
+    ASSERT_TRUE(tm.child_set().contains(d));
+    ASSERT_EQ(tm.delete_task(b), 0);
+    return 0;
+}
+
+// A subtree goes in one call, out of its parent, its owners and the indexes.
+static int test_delete_subtree_unlinks_everything() {
+    TaskManager tm;
+    Person alice("Alice", 1);
+    Person bob("Bob", 2);
+    int root = tm.create_task("Root", "");
+    int top = tm.create_task("Top", "", &alice);
+    int mid = tm.create_task("Mid", "", &bob);
+    int leaf = tm.create_task("Leaf", "", &alice);
+    int other = tm.create_task("Other", "", &alice);
+    tm.make_child_task(root, top);
+    tm.make_child_task(top, mid);
+    tm.make_child_task(mid, leaf);
+    tm.make_child_task(root, other);
+    tm.mark_task_as_done(leaf);
+    ASSERT_EQ(tm.subtree_status_counts(root)[static_cast<int>(Task::Status::Done)], 1);
+
+    ASSERT_EQ(tm.delete_subtree(top), 3);
+    for (int id : {top, mid, leaf}) ASSERT_TRUE(tm.get_task(id) == nullptr);
+    auto children = tm.get_task(root)->get_children_view();
+    ASSERT_TRUE(std::vector<Task*>(children.begin(), children.end()) == (std::vector<Task*>{tm.get_task(other)}));
+    ASSERT_EQ(alice.get_tasks_view().size(), 1u);
+    ASSERT_TRUE(bob.get_tasks_view().empty());
+    ASSERT_TRUE(tm.tasks_with_status(Task::Status::Done).empty());
+    ASSERT_EQ(tm.count_descendants(root), 1);
+    ASSERT_EQ(tm.subtree_status_counts(root)[static_cast<int>(Task::Status::Todo)], 1);
+    ASSERT_EQ(tm.subtree_status_counts(root)[static_cast<int>(Task::Status::Done)], 0);
+    ASSERT_EQ(tm.delete_subtree(top), 0);
+
+    // The freed slots are reused by new tasks.
+    int again = tm.create_task("Again", "", &bob);
+    tm.make_child_task(other, again);
+    ASSERT_EQ(tm.get_task(again)->get_level(), 3);
+    ASSERT_EQ(tm.delete_subtree(root), 3);
+    ASSERT_TRUE(alice.get_tasks_view().empty() && bob.get_tasks_view().empty());
+    int left = 0;
+    tm.for_each_task([&](const Task*) { ++left; });
+    ASSERT_EQ(left, 0);
+    return 0;
+}
+
+// Random moves keep child lists, parent links, levels and the tree in step.
+static int test_random_moves_stay_consistent() {
+    TaskManager tm;
+    const int count = 2000;
+    std::uint32_t state = 12345;
+    auto next = [&]() { return state = state * 1664525u + 1013904223u; };
+    for (int i = 1; i <= count; ++i) {
+        int id = tm.create_task("Task", "");
+        if (i > 1 && next() % 4) tm.make_child_task(1 + static_cast<int>(next() % (id - 1)), id);
+    }
+    for (int round = 0; round < 20000; ++round) {
+        int id = 1 + static_cast<int>(next() % count);
+        int parent = next() % 10 == 0 ? 0 : 1 + static_cast<int>(next() % count);
+        int expected = parent != id && !tm.is_descendant(parent, id);
+        ASSERT_EQ(tm.move_task(id, parent), expected);
+    }
+    int linked = 0;
+    for (int id = 1; id <= count; ++id) {
+        const Task* task = tm.get_task(id);
+        const Task* parent = task->get_parent();
+        ASSERT_EQ(task->get_level(), parent ? parent->get_level() + 1 : 1);
+        for (const Task* child : task->get_children_view()) {
+            ASSERT_TRUE(child->get_parent() == task);
+            ++linked;
+        }
+        int depth = 0;
+        for (const Task* at = parent; at; at = at->get_parent()) {
+            ASSERT_TRUE(tm.is_descendant(id, at->get_id()));
+            ++depth;
+        }
+        ASSERT_EQ(depth + 1, task->get_level());
+    }
+    ASSERT_EQ(static_cast<size_t>(linked), tm.child_set().count());
+    return 0;
+}
+
+// Subtree status counts match a walk of the subtree, whether they were kept
+// up to date through the changes or built afterwards.
+static int test_rollups_follow_changes() {
+    TaskManager kept, built;
+    ASSERT_TRUE(kept.subtree_status_counts(1) == TaskManager::StatusCounts{});  // Builds them early
+    const int count = 500;
+    std::uint32_t state = 777;
+    auto next = [&]() { return state = state * 1664525u + 1013904223u; };
+    for (TaskManager* tm : {&kept, &built}) {
+        state = 777;
+        for (int i = 1; i <= count; ++i) {
+            int id = tm->create_task("Task", "");
+            if (i > 1 && next() % 4) tm->make_child_task(1 + static_cast<int>(next() % (id - 1)), id);
+        }
+        if (tm == &kept) kept.subtree_status_counts(1);
+        for (int round = 0; round < 5000; ++round) {
+            int id = 1 + static_cast<int>(next() % count);
+            std::uint32_t action = next() % 10;
+            if (!tm->get_task(id)) continue;
+            if (action < 5) {
+                tm->get_task(id)->set_status(static_cast<Task::Status>(next() % Task::status_count));
+            } else if (action < 6) {
+                tm->advance_task_status(id);
+            } else if (action < 9) {
+                tm->move_task(id, next() % 10 == 0 ? 0 : 1 + static_cast<int>(next() % count));
+            } else if (next() % 2) {
+                tm->delete_task(id);
+            } else {
+                tm->delete_subtree(id);
+            }
+        }
+    }
+    for (int id = 1; id <= count; ++id) {
+        TaskManager::StatusCounts expected{};
+        kept.for_each_descendant(id, [&](const Task* task, int) { ++expected[static_cast<int>(task->get_status())]; });
+        ASSERT_TRUE(kept.subtree_status_counts(id) == expected);
+        ASSERT_TRUE(built.subtree_status_counts(id) == expected);
+    }
+    return 0;
+}
+
+// Nested printing walks without recursing, so depth is no limit. Records
+// carry no indentation, which keeps a deep chain's output linear.
+static int test_deep_chain_prints_iteratively() {
+    TaskManager tm;
+    const int depth = 300000;
+    for (int i = 1; i <= depth; ++i) {
+        int id = tm.create_task("Task", "");
+        if (i > 1) tm.make_child_task(id - 1, id);
+    }
+    int visited = 0, deepest = 0;
+    walk_task_tree(tm.get_task(1), [&](const Task*, int d) {
+        ++visited;
+        deepest = std::max(deepest, d);
+        return true;
+    });
+    ASSERT_EQ(visited, depth);
+    ASSERT_EQ(deepest, depth - 1);
+
+    std::ostringstream captured;
+    std::streambuf* saved = std::cout.rdbuf(captured.rdbuf());
+    PrintOptions options;
+    options.nested = true;
+    options.format = OutputFormat::Csv;
+    tm.print_task(1, options);
+    get_output().flush();
+    std::cout.rdbuf(saved);
+    std::string csv = captured.str();
+    ASSERT_EQ(std::count(csv.begin(), csv.end(), '\n'), depth + 1);  // Header and one row per task
+    return 0;
+}
+
+// Text output lists children in child-list order, each under its parent.
+static int test_nested_text_order() {
+    TaskManager tm;
+    for (const char* name : {"A", "B", "C", "D", "E"}) tm.create_task(name, "");
+    tm.make_child_task(1, 2);
+    tm.make_child_task(1, 3);
+    tm.make_child_task(2, 4);
+    tm.make_child_task(1, 5);
+    tm.move_task(2, 0);  // 5 takes 2's slot under 1
+
+    std::ostringstream captured;
+    std::streambuf* saved = std::cout.rdbuf(captured.rdbuf());
+    PrintOptions options;
+    options.nested = true;
+    tm.print_all_tasks(options);
+    get_output().flush();
+    std::cout.rdbuf(saved);
+    std::string ids;
+    std::istringstream lines(captured.str());
+    for (std::string line; std::getline(lines, line);) {
+        if (line.find("Task ID: ") != std::string::npos) ids += line + "|";
+    }
+    ASSERT_EQ(ids, "Task ID: 1|--Task ID: 5|--Task ID: 3|Task ID: 2|--Task ID: 4|");
+    return 0;
+}
+
 // Deleting all tasks on an empty manager should be safe and keep it empty.
 static int test_delete_all_tasks_is_idempotent_and_safe() {
     TaskManager tm;
@@ -201,17 +485,147 @@ static int test_parent_child_operations() {
     return 0;
 }
 
+// IDs are monotonic: deleting a task must not free its ID for the next create.
+static int test_ids_are_not_reused_after_delete() {
+    TaskManager tm;
+    int first = tm.create_task("First", "First task", nullptr);
+    int second = tm.create_task("Second", "Second task", nullptr);
+    ASSERT_EQ(second, first + 1);
+
+    ASSERT_EQ(tm.delete_task(second), 1);
+    ASSERT_TRUE(tm.get_task(second) == nullptr);
+    ASSERT_EQ(tm.delete_task(second), 0);  // already gone
+
+    int third = tm.create_task("Third", "Third task", nullptr);
+    ASSERT_EQ(third, second + 1);
+    ASSERT_EQ(tm.get_task(first)->get_name(), "First");
+    ASSERT_EQ(tm.get_task(third)->get_name(), "Third");
+
+    tm.delete_all_tasks();
+    int fourth = tm.create_task("Fourth", "Fourth task", nullptr);
+    ASSERT_EQ(fourth, third + 1);
+    ASSERT_TRUE(tm.get_task(first) == nullptr);
+    return 0;
+}
+
+// The columnar counts must follow every mutation path, including direct Task calls.
+static int test_status_counts_follow_mutations() {
+    TaskManager tm;
+    Person person("Counter", 7);
+    int a = tm.create_task("A", "Task A", &person);
+    int b = tm.create_task("B", "Task B", nullptr);
+    int c = tm.create_task("C", "Task C", nullptr);
+
+    auto counts = tm.count_tasks_by_status();
+    ASSERT_EQ(counts[static_cast<int>(Task::Status::Todo)], 3);
+    ASSERT_EQ(tm.count_tasks_owned_by(person.get_id()), 1);
+
+    tm.advance_task_status(a);
+    tm.get_task(b)->mark_as_done();
+    tm.get_task(c)->set_status(Task::Status::Blocked);
+    tm.assign_task(c, &person);
+    counts = tm.count_tasks_by_status();
+    ASSERT_EQ(counts[static_cast<int>(Task::Status::Todo)], 0);
+    ASSERT_EQ(counts[static_cast<int>(Task::Status::InProgress)], 1);
+    ASSERT_EQ(counts[static_cast<int>(Task::Status::Blocked)], 1);
+    ASSERT_EQ(counts[static_cast<int>(Task::Status::Done)], 1);
+    ASSERT_EQ(tm.count_tasks_owned_by(person.get_id()), 2);
+
+    tm.delete_task(a);
+    counts = tm.count_tasks_by_status();
+    ASSERT_EQ(counts[static_cast<int>(Task::Status::InProgress)], 0);
+    ASSERT_EQ(tm.count_tasks_owned_by(person.get_id()), 1);
+
+    tm.delete_all_tasks();
+    counts = tm.count_tasks_by_status();
+    ASSERT_EQ(counts[static_cast<int>(Task::Status::Done)], 0);
+    ASSERT_EQ(tm.count_tasks_owned_by(person.get_id()), 0);
+    return 0;
+}
+
+// The status and (owner, status) indexes and the membership bitmaps must agree with the tasks after
+// every mutation path.
+static int test_indexes_follow_mutations() {
+    TaskManager tm;
+    Person alice("Alice", 1);
+    Person bob("Bob", 2);
+    auto sorted = [](std::span<const std::int32_t> ids) {
+        std::vector<std::int32_t> v(ids.begin(), ids.end());
+        std::sort(v.begin(), v.end());
+        return v;
+    };
+    using V = std::vector<std::int32_t>;
+    const Task::Status todo = Task::Status::Todo, done = Task::Status::Done;
+
+    int a = tm.create_task("A", "", &alice);
+    int b = tm.create_task("B", "", &alice);
+    int c = tm.create_task("C", "", nullptr);
+    ASSERT_TRUE(sorted(tm.tasks_with_status(todo)) == (V{a, b, c}));
+    ASSERT_TRUE(sorted(tm.tasks_with_owner_and_status(1, todo)) == (V{a, b}));
+    ASSERT_TRUE(sorted(tm.tasks_with_owner_and_status(0, todo)) == (V{c}));
+
+    tm.make_child_task(a, b);
+    ASSERT_TRUE(tm.child_set().contains(b) && !tm.child_set().contains(a));
+    PrintOptions top_level, nested;
+    nested.nested = true;
+    ASSERT_EQ(alice.return_number_of_tasks(tm.owner_set(alice.get_id()), tm.child_set(), top_level), 1);
+    ASSERT_EQ(alice.return_number_of_tasks(tm.owner_set(alice.get_id()), tm.child_set(), nested), 2);
+
+    tm.advance_task_status(a);
+    tm.get_task(c)->set_status(Task::Status::Blocked);
+    alice.set_all_tasks_to_done();
+    ASSERT_EQ(tm.status_set(done).count(), 2u);
+    ASSERT_EQ(IdBitmap::and_count(tm.owner_set(1), tm.status_set(done)), 2u);
+    ASSERT_TRUE(tm.tasks_with_status(todo).empty());
+    ASSERT_TRUE(sorted(tm.tasks_with_owner_and_status(1, done)) == (V{a, b}));
+    ASSERT_TRUE(sorted(tm.tasks_with_owner_and_status(0, Task::Status::Blocked)) == (V{c}));
+
+    tm.assign_task(c, &bob);
+    tm.get_task(b)->set_owner(&bob);
+    ASSERT_TRUE(tm.tasks_with_owner_and_status(0, Task::Status::Blocked).empty());
+    ASSERT_TRUE(sorted(tm.tasks_with_owner_and_status(2, done)) == (V{b}));
+    ASSERT_TRUE(sorted(tm.tasks_with_owner_and_status(2, Task::Status::Blocked)) == (V{c}));
+
+    tm.delete_task(a);
+    bob.remove_all_tasks();
+    ASSERT_TRUE(sorted(tm.tasks_with_status(done)) == (V{b}));
+    ASSERT_TRUE(tm.tasks_with_owner_and_status(1, done).empty());
+    ASSERT_TRUE(sorted(tm.tasks_with_owner_and_status(0, done)) == (V{b}));
+    ASSERT_TRUE(tm.tasks_with_owner_and_status(99, done).empty());
+    ASSERT_TRUE(tm.owner_set(2).empty() && tm.owner_set(99).empty());
+    ASSERT_TRUE(!tm.child_set().contains(a));
+
+    tm.delete_all_tasks();
+    ASSERT_TRUE(tm.tasks_with_status(done).empty());
+    ASSERT_TRUE(tm.tasks_with_owner_and_status(0, done).empty());
+    ASSERT_TRUE(tm.status_set(done).empty() && tm.child_set().empty());
+    int d = tm.create_task("D", "", &alice);
+    ASSERT_TRUE(sorted(tm.tasks_with_owner_and_status(1, todo)) == (V{d}));
+    return 0;
+}
+
 // --- Main runner ---
 int main() {
     int fails = 0;
     fails += test_create_and_delete_task();
     fails += test_get_task_on_empty_manager_returns_null();
     fails += test_make_child_task_fails_when_ids_missing();
+    fails += test_make_child_task_rejects_cycles();
+    fails += test_move_task_renumbers_subtree();
+    fails += test_delete_task_promotes_children();
+    fails += test_delete_subtree_unlinks_everything();
+    fails += test_random_moves_stay_consistent();
+    fails += test_rollups_follow_changes();
+    fails += test_deep_chain_prints_iteratively();
+    fails += test_nested_text_order();
     fails += test_delete_all_tasks_is_idempotent_and_safe();
     fails += test_print_all_task_owners_does_not_throw();
     fails += test_ownership_operations();
     fails += test_task_status_operations();
     fails += test_parent_child_operations();
+    fails += test_ids_are_not_reused_after_delete();
+    fails += test_status_counts_follow_mutations();
+    fails += test_indexes_follow_mutations();
 
     if (fails == 0) {
         std::cout << "[task_manager_unit_test] All tests passed\n";
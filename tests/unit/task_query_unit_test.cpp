@@ -0,0 +1,190 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "person.hpp"
+#include "person_manager.hpp"
+#include "task.hpp"
+#include "task_manager.hpp"
+#include "task_query.hpp"
+
+// --- Tiny assert helpers ---
+#define ASSERT_TRUE(cond) do { \
+    if(!(cond)) { \
+        std::cerr << "[FAIL] " << __FILE__ << ":" << __LINE__ \
+                  << " ASSERT_TRUE(" << #cond << ")\n"; \
+        return 1; \
+    } \
+} while(0)
+
+#define ASSERT_EQ(a,b) do { \
+    if(!((a) == (b))) { \
+        std::cerr << "[FAIL] " << __FILE__ << ":" << __LINE__ \
+                  << " ASSERT_EQ(" << #a << "," << #b << ") got (" \
+                  << (a) << "," << (b) << ")\n"; \
+        return 1; \
+    } \
+} while(0)
+
+// 3000 tasks in chains of three (levels 1-3), statuses cycling, every third
+// task owned by alice and every fifth by bob. Task 99, a leaf, is deleted.
+static void populate(TaskManager& tm, PersonManager& pm) {
+    pm.add_person("alice");
+    pm.add_person("bob");
+    Person* alice = pm.find_person_by_name("alice");
+    Person* bob = pm.find_person_by_name("bob");
+    for (int i = 1; i <= 3000; ++i) {
+        Person* owner = i % 3 == 0 ? alice : (i % 5 == 0 ? bob : nullptr);
+        int id = tm.create_task("Task " + std::to_string(i), "", owner);
+        tm.get_task(id)->set_status(static_cast<Task::Status>(i % Task::status_count));
+        if (i % 3 != 1) tm.make_child_task(id - 1, id);
+    }
+    tm.delete_task(99);
+}
+
+// The same query answered by walking every task.
+static std::vector<int> brute_force(const TaskManager& tm, const std::vector<std::string_view>& terms,
+                                    const PersonManager& pm) {
+    TaskQuery query;
+    std::string error;
+    compile_task_query(terms, pm, query, error);
+    std::vector<int> ids;
+    tm.for_each_task([&](const Task* task) {
+        for (const TaskPredicate& p : query.predicates) {
+            if (p.field == TaskField::Under) {
+                const Task* at = task->get_parent();
+                while (at && at->get_id() != p.value) at = at->get_parent();
+                if (!at) return;
+                continue;
+            }
+            int value = p.field == TaskField::Id ? task->get_id()
+                      : p.field == TaskField::Status ? static_cast<int>(task->get_status())
+                      : p.field == TaskField::Owner ? (task->get_owner() ? task->get_owner()->get_id() : 0)
+                      : p.field == TaskField::Parent ? (task->get_parent() ? task->get_parent()->get_id() : 0)
+                      : task->get_level();
+            bool ok = p.op == CompareOp::Eq ? value == p.value
+                    : p.op == CompareOp::Ne ? value != p.value
+                    : p.op == CompareOp::Lt ? value < p.value
+                    : p.op == CompareOp::Le ? value <= p.value
+                    : p.op == CompareOp::Gt ? value > p.value
+                    : value >= p.value;
+            if (!ok) return;
+        }
+        ids.push_back(task->get_id());
+    });
+    return ids;
+}
+
+// --- Tests ---
+int test_results_match_brute_force() {
+    TaskManager tm;
+    PersonManager pm;
+    populate(tm, pm);
+    for (int id = 4; id <= 1200; id += 3) tm.make_child_task(1, id);  // A subtree too big for a list
+
+    const std::vector<std::vector<std::string_view>> queries = {
+        {},
+        {"status=InProgress"},
+        {"status!=Done", "level<=2"},
+        {"owner=alice", "status=2"},
+        {"owner=none", "level>1"},
+        {"owner!=bob", "parent=none"},
+        {"parent=97"},
+        {"parent=98"},
+        {"parent=99"},
+        {"parent=9999", "owner=alice"},
+        {"id>=2990"},
+        {"id=99"},
+        {"id=100"},
+        {"level>=3", "owner=bob", "status<4"},
+        {"owner=bob", "status=Blocked", "level>1"},
+        {"owner=none", "status=Todo"},
+        {"status=Done", "status=Todo"},
+        {"under=1"},
+        {"under=1", "owner=bob"},
+        {"under=97"},
+        {"under=4", "level=3"},
+        {"under=99"},
+        {"status=Blocked", "under=1"},
+    };
+    QueryResult result;
+    for (const auto& terms : queries) {
+        TaskQuery query;
+        std::string error;
+        ASSERT_TRUE(compile_task_query(terms, pm, query, error));
+        tm.select(query, result);
+        std::vector<int> expected = brute_force(tm, terms, pm);
+        ASSERT_EQ(result.ids.size(), expected.size());
+        ASSERT_TRUE(result.ids == expected);
+    }
+    tm.unown_all_tasks();
+    return 0;
+}
+
+// An index list is only used when it is much shorter than a scan: here
+// only carol's tasks and the Done tasks past ID 2900 qualify.
+int test_planner_picks_the_cheapest_access() {
+    TaskManager tm;
+    PersonManager pm;
+    populate(tm, pm);
+    pm.add_person("carol");
+    Person* carol = pm.find_person_by_name("carol");
+    for (int id : {10, 11, 12}) tm.assign_task(id, carol);
+    tm.for_each_task([](Task* task) {
+        if (task->is_done() && task->get_id() < 2900) task->set_status(Task::Status::Todo);
+    });
+
+    auto access_of = [&](std::vector<std::string_view> terms) {
+        TaskQuery query;
+        std::string error;
+        compile_task_query(terms, pm, query, error);
+        QueryResult result;
+        tm.select(query, result);
+        return result.access;
+    };
+    ASSERT_TRUE(access_of({"status=Done"}) == QueryAccess::Status);
+    ASSERT_TRUE(access_of({"status=Todo"}) == QueryAccess::Scan);
+    ASSERT_TRUE(access_of({"status!=Done"}) == QueryAccess::Scan);
+    ASSERT_TRUE(access_of({"owner=carol"}) == QueryAccess::Owner);
+    ASSERT_TRUE(access_of({"owner=alice"}) == QueryAccess::Scan);
+    ASSERT_TRUE(access_of({"owner=alice", "status=Done"}) == QueryAccess::OwnerStatus);
+    ASSERT_TRUE(access_of({"owner=carol", "parent=9"}) == QueryAccess::Children);
+    ASSERT_TRUE(access_of({"owner=carol", "parent=7", "id=8"}) == QueryAccess::Id);
+    ASSERT_TRUE(access_of({"under=97"}) == QueryAccess::Subtree);
+    ASSERT_TRUE(access_of({"owner!=carol"}) == QueryAccess::Scan);
+    tm.unown_all_tasks();
+    return 0;
+}
+
+int test_compile_errors() {
+    PersonManager pm;
+    pm.add_person("alice");
+    const std::vector<std::vector<std::string_view>> bad = {
+        {"status"}, {"status="}, {"colour=red"}, {"status=Sleeping"}, {"owner=carol"},
+        {"owner<alice"}, {"level<=two"}, {"=3"}, {"level!3"}, {"under>3"}, {"under=none"},
+    };
+    for (const auto& terms : bad) {
+        TaskQuery query;
+        std::string error;
+        ASSERT_TRUE(!compile_task_query(terms, pm, query, error));
+        ASSERT_TRUE(!error.empty());
+    }
+    return 0;
+}
+
+// --- Main runner ---
+int main() {
+    int fails = 0;
+    fails += test_results_match_brute_force();
+    fails += test_planner_picks_the_cheapest_access();
+    fails += test_compile_errors();
+
+    if (fails == 0) {
+        std::cout << "[task_query_unit_test] All tests passed\n";
+        return 0;
+    } else {
+        std::cout << "[task_query_unit_test] " << fails << " tests failed\n";
+        return 1;
+    }
+}
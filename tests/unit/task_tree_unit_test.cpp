@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "task_tree.hpp"
+
+// --- Tiny assert helpers ---
+#define ASSERT_TRUE(cond) do { \
+    if(!(cond)) { \
+        std::cerr << "[FAIL] " << __FILE__ << ":" << __LINE__ \
+                  << " ASSERT_TRUE(" << #cond << ")\n"; \
+        return 1; \
+    } \
+} while(0)
+
+#define ASSERT_EQ(a,b) do { \
+    if(!((a) == (b))) { \
+        std::cerr << "[FAIL] " << __FILE__ << ":" << __LINE__ \
+                  << " ASSERT_EQ(" << #a << "," << #b << ") got (" \
+                  << (a) << "," << (b) << ")\n"; \
+        return 1; \
+    } \
+} while(0)
+
+// The same forest as parent links and ordered child lists, 0 being the root.
+struct Reference {
+    std::vector<int> parent;
+    std::vector<std::vector<int>> children;
+
+    explicit Reference(int size) : parent(size, -1), children(size) {}
+
+    bool contains(int id) const { return parent[id] >= 0; }
+    bool is_descendant(int id, int ancestor) const {
+        if (!contains(id) || !contains(ancestor)) return false;
+        for (int at = parent[id]; at > 0; at = parent[at]) {
+            if (at == ancestor) return true;
+        }
+        return false;
+    }
+    void detach(int id) {
+        auto& siblings = children[parent[id]];
+        siblings.erase(std::find(siblings.begin(), siblings.end(), id));
+    }
+    void erase_subtree(int id) {
+        for (int child : children[id]) erase_subtree(child);
+        children[id].clear();
+        parent[id] = -1;
+    }
+    void pre_order(int id, int depth, std::vector<std::pair<int, int>>& out) const {
+        for (int child : children[id]) {
+            out.emplace_back(child, depth);
+            pre_order(child, depth + 1, out);
+        }
+    }
+};
+
+static std::vector<std::pair<int, int>> descendants_of(const TaskTree& tree, int id) {
+    std::vector<std::pair<int, int>> out;
+    tree.for_each_descendant(id, [&](int descendant, int depth) {
+        out.emplace_back(descendant, depth);
+        return true;
+    });
+    return out;
+}
+
+// --- Tests ---
+
+// Random inserts, moves, erases and subtree erases, checked against the parent links.
+int test_matches_parent_links() {
+    const int size = 400;
+    TaskTree tree;
+    tree.resize(size);
+    Reference reference(size);
+    reference.parent[0] = 0;
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> pick(1, size - 1);
+    for (int round = 0; round < 20000; ++round) {
+        int id = pick(rng), other = pick(rng);
+        if (!reference.contains(id)) {
+            tree.insert(id);
+            reference.parent[id] = 0;
+            reference.children[0].push_back(id);
+        } else if (round % 23 == 0) {
+            reference.detach(id);
+            reference.erase_subtree(id);
+            tree.erase_subtree(id);
+        } else if (round % 7 == 0) {
+            // Children move up into the erased task's place.
+            auto& siblings = reference.children[reference.parent[id]];
+            auto at = siblings.erase(std::find(siblings.begin(), siblings.end(), id));
+            for (int child : reference.children[id]) reference.parent[child] = reference.parent[id];
+            siblings.insert(at, reference.children[id].begin(), reference.children[id].end());
+            reference.children[id].clear();
+            reference.parent[id] = -1;
+            tree.erase(id);
+        } else {
+            if (!reference.contains(other) || other == id || reference.is_descendant(other, id)) other = 0;
+            tree.attach(id, other);
+            reference.detach(id);
+            reference.parent[id] = other;
+            reference.children[other].push_back(id);
+        }
+        if (round % 500 == 0) {
+            for (int a = 1; a < size; ++a) {
+                ASSERT_EQ(tree.contains(a), reference.contains(a));
+                for (int b = 1; b < size; b += 13) {
+                    ASSERT_EQ(tree.is_descendant(a, b), reference.is_descendant(a, b));
+                }
+            }
+        }
+    }
+    for (int id = 1; id < size; ++id) {
+        if (!reference.contains(id)) continue;
+        std::vector<std::pair<int, int>> expected;
+        reference.pre_order(id, 1, expected);
+        ASSERT_TRUE(descendants_of(tree, id) == expected);
+        ASSERT_EQ(tree.count_descendants(id), expected.size());
+    }
+    return 0;
+}
+
+// A chain keeps splitting the same gap, which forces relabeling; the
+// labels must stay ordered and the relabeling amortized.
+int test_deep_chain_relabels() {
+    const int depth = 200000;
+    TaskTree tree;
+    tree.resize(depth + 1);
+    tree.insert(1);
+    for (int id = 2; id <= depth; ++id) {
+        tree.insert(id);
+        tree.attach(id, id - 1);
+    }
+    ASSERT_TRUE(tree.is_descendant(depth, 1));
+    ASSERT_TRUE(tree.is_descendant(depth / 2 + 1, depth / 2));
+    ASSERT_TRUE(!tree.is_descendant(depth / 2, depth / 2 + 1));
+    ASSERT_EQ(tree.count_descendants(1), static_cast<std::size_t>(depth - 1));
+    ASSERT_EQ(tree.count_descendants(1, 10), 10u);
+    int last_depth = 0;
+    tree.for_each_descendant(1, [&](int, int d) { last_depth = d; return true; });
+    ASSERT_EQ(last_depth, depth - 1);
+    ASSERT_TRUE(tree.relabel_count() < static_cast<std::size_t>(depth) * 64);
+
+    // Moving the bottom half to the top level keeps both halves intact.
+    tree.attach(depth / 2 + 1, 0);
+    ASSERT_TRUE(!tree.is_descendant(depth, 1));
+    ASSERT_TRUE(tree.is_descendant(depth, depth / 2 + 1));
+    ASSERT_EQ(tree.count_descendants(1), static_cast<std::size_t>(depth / 2 - 1));
+    return 0;
+}
+
+int test_filter_descendants() {
+    TaskTree tree;
+    tree.resize(10);
+    for (int id = 1; id <= 6; ++id) tree.insert(id);
+    tree.attach(2, 1);
+    tree.attach(3, 2);
+    tree.attach(5, 1);
+    tree.erase(4);
+    std::uint8_t keep[9] = {1, 1, 1, 1, 1, 1, 1, 1, 1};
+    tree.filter_descendants(keep, 1, 9, 1);  // Slots 1 to 9
+    const std::uint8_t expected[9] = {0, 1, 1, 0, 1, 0, 0, 0, 0};
+    ASSERT_TRUE(std::equal(keep, keep + 9, expected));
+    std::fill_n(keep, 9, std::uint8_t{1});
+    tree.filter_descendants(keep, 1, 9, 4);  // Erased
+    ASSERT_TRUE(std::count(keep, keep + 9, 0) == 9);
+    return 0;
+}
+
+// --- Main runner ---
+int main() {
+    int fails = 0;
+    fails += test_matches_parent_links();
+    fails += test_deep_chain_relabels();
+    fails += test_filter_descendants();
+
+    if (fails == 0) {
+        std::cout << "[task_tree_unit_test] All tests passed\n";
+        return 0;
+    } else {
+        std::cout << "[task_tree_unit_test] " << fails << " tests failed\n";
+        return 1;
+    }
+}
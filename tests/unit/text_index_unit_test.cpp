@@ -0,0 +1,145 @@
+#include <cstdint>
+#include <iostream>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "task_manager.hpp"
+#include "text_index.hpp"
+
+// --- Tiny assert helpers ---
+#define ASSERT_TRUE(cond) do { \
+    if(!(cond)) { \
+        std::cerr << "[FAIL] " << __FILE__ << ":" << __LINE__ \
+                  << " ASSERT_TRUE(" << #cond << ")\n"; \
+        return 1; \
+    } \
+} while(0)
+
+#define ASSERT_EQ(a,b) do { \
+    if(!((a) == (b))) { \
+        std::cerr << "[FAIL] " << __FILE__ << ":" << __LINE__ \
+                  << " ASSERT_EQ(" << #a << "," << #b << ") got (" \
+                  << (a) << "," << (b) << ")\n"; \
+        return 1; \
+    } \
+} while(0)
+
+static std::vector<int> ids_of(const std::vector<SearchHit>& hits) {
+    std::vector<int> ids;
+    for (const SearchHit& hit : hits) ids.push_back(hit.id);
+    return ids;
+}
+
+// --- Tests ---
+int test_intersect() {
+    std::vector<std::int32_t> a{1, 3, 5, 7, 9, 11}, b{3, 4, 5, 9, 12}, c;
+    for (std::int32_t id = 0; id < 1000; ++id) c.push_back(id * 3);  // Long: binary searched
+    std::vector<std::span<const std::int32_t>> lists{a, b, c};
+    std::vector<std::int32_t> ids;
+    TextIndex::intersect(lists, ids);
+    ASSERT_TRUE(ids == (std::vector<std::int32_t>{3, 9}));
+    lists = {a};
+    TextIndex::intersect(lists, ids);
+    ASSERT_TRUE(ids == a);
+    return 0;
+}
+
+int test_tokenize() {
+    std::vector<std::string> tokens;
+    TextIndex::tokenize("  Fix the LOGIN-page, v2 (again)! café", tokens);
+    ASSERT_TRUE(tokens == (std::vector<std::string>{"fix", "the", "login", "page", "v2", "again", "café"}));
+    tokens.clear();
+    TextIndex::tokenize(" -- ", tokens);
+    ASSERT_TRUE(tokens.empty());
+    return 0;
+}
+
+int test_index_add_and_remove() {
+    TextIndex index;
+    index.add(1, "Fix login", "The login page hangs");
+    index.add(2, "Write docs", "Explain logging");
+    auto candidates = [&](std::string_view term) {
+        std::vector<std::span<const std::int32_t>> lists;
+        std::vector<std::int32_t> ids;
+        if (index.candidate_lists(term, lists)) TextIndex::intersect(lists, ids);
+        return ids;
+    };
+    ASSERT_TRUE(candidates("log") == (std::vector<std::int32_t>{1, 2}));
+    ASSERT_TRUE(candidates("login") == (std::vector<std::int32_t>{1}));
+    ASSERT_EQ(index.word_matches("docs").size(), 1u);
+    ASSERT_TRUE(candidates("zzz").empty());
+    std::vector<std::span<const std::int32_t>> lists;
+    ASSERT_TRUE(index.candidate_lists("fi", lists) && lists.empty());  // Too short to narrow anything
+
+    index.remove(1, "Fix login", "The login page hangs");
+    ASSERT_TRUE(candidates("login").empty());
+    ASSERT_TRUE(index.word_matches("fix").empty());
+    index.remove(2, "Write docs", "Explain logging");
+    ASSERT_EQ(index.word_count(), 0u);
+    ASSERT_EQ(index.trigram_count(), 0u);
+    return 0;
+}
+
+int test_search_ranks_and_follows_edits() {
+    TaskManager tm;
+    int login = tm.create_task("Fix login", "Users cannot log in");
+    int page = tm.create_task("Restyle the page", "Login page colours");
+    int logging = tm.create_task("Logging", "Add structured logs");
+    int other = tm.create_task("Unrelated", "Nothing here");
+
+    std::vector<SearchHit> hits;
+    ASSERT_EQ(tm.search("LOGIN", hits), 1);
+    // Whole word in the name beats whole word in the description.
+    ASSERT_TRUE(ids_of(hits) == (std::vector<int>{login, page}));
+    ASSERT_TRUE(hits[0].score > hits[1].score);
+
+    tm.search("log", hits);  // Substrings count, whole words rank higher
+    ASSERT_EQ(hits.size(), 3u);
+    ASSERT_EQ(hits[0].id, login);
+
+    tm.search("login page", hits);  // Every word must match
+    ASSERT_TRUE(ids_of(hits) == (std::vector<int>{page}));
+
+    tm.search("in", hits);  // Short words match inside longer ones too
+    ASSERT_TRUE(ids_of(hits) == (std::vector<int>{login, logging, page, other}));
+    ASSERT_TRUE(hits[0].score > hits[1].score);  // The whole word "in" ranks first
+    tm.search("log in", hits);  // The longer word narrows the candidates
+    ASSERT_TRUE(ids_of(hits) == (std::vector<int>{login, logging, page}));
+    tm.search("Q", hits);  // Nowhere, not even inside a word
+    ASSERT_TRUE(hits.empty());
+
+    tm.create_task("Login audit trail", "");  // Indexed as it is created
+    tm.set_task_name(other, "Login audit");
+    tm.set_task_description(page, "Colours");
+    tm.delete_task(login);
+    tm.search("login", hits);
+    ASSERT_TRUE(ids_of(hits) == (std::vector<int>{other, other + 1}));
+    tm.search("colours", hits);
+    ASSERT_TRUE(ids_of(hits) == (std::vector<int>{page}));
+    tm.search("nothing", hits);
+    ASSERT_TRUE(ids_of(hits) == (std::vector<int>{other}));
+
+    ASSERT_EQ(tm.search(" ?! ", hits), 0);
+    tm.delete_all_tasks();
+    tm.search("logging", hits);
+    ASSERT_TRUE(hits.empty() && logging > 0);
+    return 0;
+}
+
+// --- Main runner ---
+int main() {
+    int fails = 0;
+    fails += test_tokenize();
+    fails += test_intersect();
+    fails += test_index_add_and_remove();
+    fails += test_search_ranks_and_follows_edits();
+
+    if (fails == 0) {
+        std::cout << "[text_index_unit_test] All tests passed\n";
+        return 0;
+    } else {
+        std::cout << "[text_index_unit_test] " << fails << " tests failed\n";
+        return 1;
+    }
+}
@@ -0,0 +1,167 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "json_stream.hpp"
+#include "person_manager.hpp"
+#include "person.hpp"
+#include "task_manager.hpp"
+#include "task.hpp"
+#include "workspace_json.hpp"
+
+// --- Tiny assert helpers ---
+#define ASSERT_TRUE(cond) do { \
+    if(!(cond)) { \
+        std::cerr << "[FAIL] " << __FILE__ << ":" << __LINE__ \
+                  << " ASSERT_TRUE(" << #cond << ")\n"; \
+        return 1; \
+    } \
+} while(0)
+
+#define ASSERT_EQ(a,b) do { \
+    if(!((a) == (b))) { \
+        std::cerr << "[FAIL] " << __FILE__ << ":" << __LINE__ \
+                  << " ASSERT_EQ(" << #a << "," << #b << ") got (" \
+                  << (a) << "," << (b) << ")\n"; \
+        return 1; \
+    } \
+} while(0)
+
+// --- Tests ---
+int test_round_trip_through_json() {
+    std::stringstream json;
+    {
+        TaskManager tm;
+        PersonManager pm;
+        pm.add_person("alice");
+        pm.add_person("bob \"the builder\"");
+        tm.create_task("Root", "Line one\nLine two\t\\", pm.find_person_by_name("alice"));
+        tm.create_task("Gone", "");
+        tm.create_task("Child", "caf\xc3\xa9", pm.find_person_by_name("bob \"the builder\""));
+        tm.create_task("Grandchild", "\x01");
+        tm.delete_task(2);
+        tm.make_child_task(1, 3);
+        tm.make_child_task(3, 4);
+        tm.mark_task_as_done(4);
+        ASSERT_EQ(export_json(json, tm, pm), 1);
+    }
+
+    TaskManager tm;
+    PersonManager pm;
+    ASSERT_EQ(import_json(json, tm, pm), 1);
+    ASSERT_TRUE(tm.get_task(2) == nullptr);
+    ASSERT_EQ(tm.get_task(1)->get_description(), "Line one\nLine two\t\\");
+    ASSERT_EQ(tm.get_task(3)->get_description(), "caf\xc3\xa9");
+    ASSERT_EQ(tm.get_task(4)->get_description(), "\x01");
+    ASSERT_TRUE(tm.get_task(3)->get_owner() == pm.find_person_by_name("bob \"the builder\""));
+    ASSERT_EQ(tm.get_task(4)->get_parent()->get_id(), 3);
+    ASSERT_EQ(tm.get_task(4)->get_level(), 3);
+    ASSERT_TRUE(tm.get_task(4)->is_done());
+    ASSERT_EQ(tm.get_next_id(), 5);
+    return 0;
+}
+
+int test_import_accepts_other_producers() {
+    // Keys in any order, unknown keys and values skipped, a parent listed
+    // after its child, numeric status, and whitespace everywhere.
+    std::istringstream json(R"( {
+        "tasks": [
+            {"parent": 7, "name": "Child", "id": 3, "extra": {"nested": [1, 2, {"x": null}]}, "status": 1},
+            {"id": 7, "name": "Parent", "owner": null, "flag": true}
+        ],
+        "comment": ["ignored", 1.5e3],
+        "version": 1
+    } )");
+    TaskManager tm;
+    PersonManager pm;
+    ASSERT_EQ(import_json(json, tm, pm), 1);
+    ASSERT_EQ(tm.get_task(3)->get_parent()->get_id(), 7);
+    ASSERT_TRUE(tm.get_task(3)->get_status() == Task::Status::InProgress);
+    ASSERT_EQ(tm.get_next_id(), 8);
+    return 0;
+}
+
+int test_bad_documents_are_rejected() {
+    const char* documents[] = {
+        R"({"version": 2, "tasks": []})",
+        R"({"tasks": [{"id": 1, "owner": "nobody"}]})",
+        R"({"tasks": [{"id": 1}, {"id": 1}]})",
+        R"({"tasks": [{"id": 1, "parent": 2}, {"id": 2, "parent": 1}]})",
+        R"({"tasks": [{"id": 1, "parent": 9}]})",
+        R"({"tasks": [{"id": 1, "name": "unterminated}]})",
+        R"({"tasks": [{"id": 1}] "people": []})",
+        R"([1, 2, 3])",
+        R"({"tasks": [{"id": 1}]} trailing)",
+    };
+    for (const char* document : documents) {
+        std::istringstream json(document);
+        TaskManager tm;
+        PersonManager pm;
+        ASSERT_EQ(import_json(json, tm, pm), 0);
+    }
+    return 0;
+}
+
+// Syntax errors come from the parser with their byte; the importer's own
+// errors get one while parsing and none once the document has been read.
+int test_errors_name_the_byte_once() {
+    auto message_for = [](const char* document) {
+        std::istringstream json(document);
+        std::ostringstream captured;
+        std::streambuf* saved = std::cerr.rdbuf(captured.rdbuf());
+        TaskManager tm;
+        PersonManager pm;
+        import_json(json, tm, pm);
+        std::cerr.rdbuf(saved);
+        return captured.str();
+    };
+    auto byte_mentions = [](const std::string& message) {
+        int count = 0;
+        for (size_t at = message.find("byte"); at != std::string::npos; at = message.find("byte", at + 1)) ++count;
+        return count;
+    };
+
+    std::string syntax = message_for(R"({"tasks": [{"id": 1}] "people": []})");
+    ASSERT_TRUE(syntax.find("Invalid workspace JSON") != std::string::npos);
+    ASSERT_EQ(byte_mentions(syntax), 1);
+    std::string duplicate = message_for(R"({"tasks": [{"id": 1}, {"id": 1}]})");
+    ASSERT_TRUE(duplicate.find("duplicate task id 1 at byte") != std::string::npos);
+    ASSERT_EQ(byte_mentions(duplicate), 1);
+    std::string unknown_parent = message_for(R"({"tasks": [{"id": 1, "parent": 9}]})");
+    ASSERT_TRUE(unknown_parent.find("task 1 has unknown parent 9.") != std::string::npos);
+    ASSERT_EQ(byte_mentions(unknown_parent), 0);
+    return 0;
+}
+
+int test_parser_handles_tokens_across_blocks() {
+    // A 4-byte buffer forces every token to straddle a refill.
+    struct Collector : JsonHandler {
+        std::string seen;
+        bool on_key(std::string_view key) override { seen += "k:" + std::string(key) + ";"; return true; }
+        bool on_string(std::string_view text) override { seen += "s:" + std::string(text) + ";"; return true; }
+        bool on_number(std::string_view text) override { seen += "n:" + std::string(text) + ";"; return true; }
+    } collector;
+    std::istringstream json(R"({"a long key": "a \"long\" é value", "n": -12345.5e2, "list": [true]})");
+    JsonParser parser(json, 4);
+    ASSERT_EQ(parser.parse(collector), 1);
+    ASSERT_EQ(collector.seen, "k:a long key;s:a \"long\" \xc3\xa9 value;k:n;n:-12345.5e2;k:list;");
+    return 0;
+}
+
+// --- Main runner ---
+int main() {
+    int fails = 0;
+    fails += test_round_trip_through_json();
+    fails += test_import_accepts_other_producers();
+    fails += test_bad_documents_are_rejected();
+    fails += test_errors_name_the_byte_once();
+    fails += test_parser_handles_tokens_across_blocks();
+
+    if (fails == 0) {
+        std::cout << "[workspace_json_unit_test] All tests passed\n";
+        return 0;
+    } else {
+        std::cout << "[workspace_json_unit_test] " << fails << " tests failed\n";
+        return 1;
+    }
+}